@@ -0,0 +1,154 @@
+#include "background_mask.h"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <utility>
+
+size_t BackgroundMask::pixelCount() const
+{
+    size_t n = 0;
+    for (const BackgroundRun& r : runs_) n += static_cast<size_t>(r.x1 - r.x0 + 1);
+    return n;
+}
+
+void BackgroundMask::apply(uint8_t* pixels, int margin) const
+{
+    for (const BackgroundRun& r : runs_)
+    {
+        int      limit = r.level + margin;
+        uint8_t* row   = pixels + static_cast<size_t>(r.y) * width_;
+        for (int x = r.x0; x <= r.x1; x++)
+        {
+            if (row[x] <= limit) row[x] = 0;
+        }
+    }
+}
+
+bool BackgroundMask::contains(float x, float y) const
+{
+    int xi = static_cast<int>(std::lround(x));
+    int yi = static_cast<int>(std::lround(y));
+    // (y, x0) 가 (yi, xi) 보다 큰 첫 run 의 바로 앞 run 이 후보
+    auto it = std::upper_bound(runs_.begin(), runs_.end(), std::make_pair(yi, xi),
+                               [](const std::pair<int, int>& p, const BackgroundRun& r)
+                               { return p.first < r.y || (p.first == r.y && p.second < r.x0); });
+    if (it == runs_.begin()) return false;
+    --it;
+    return it->y == yi && xi >= it->x0 && xi <= it->x1;
+}
+
+std::string BackgroundMask::serialize() const
+{
+    if (runs_.empty()) return std::string();
+    std::string s = std::to_string(width_) + "," + std::to_string(height_);
+    char buf[48];
+    for (const BackgroundRun& r : runs_)
+    {
+        snprintf(buf, sizeof(buf), ";%d,%d,%d,%d", r.y, r.x0, r.x1, r.level);
+        s += buf;
+    }
+    return s;
+}
+
+bool BackgroundMask::parse(const std::string& text, BackgroundMask& out)
+{
+    out = BackgroundMask();
+    std::istringstream in(text);
+    std::string        item;
+    if (!std::getline(in, item, ';') || sscanf(item.c_str(), "%d,%d", &out.width_, &out.height_) != 2 ||
+        out.width_ <= 0 || out.height_ <= 0)
+        return false;
+
+    while (std::getline(in, item, ';'))
+    {
+        BackgroundRun r;
+        if (sscanf(item.c_str(), "%d,%d,%d,%d", &r.y, &r.x0, &r.x1, &r.level) != 4 ||
+            r.y < 0 || r.y >= out.height_ || r.x0 < 0 || r.x1 < r.x0 || r.x1 >= out.width_ ||
+            out.runs_.size() == MAX_RUNS)
+        {
+            out = BackgroundMask();
+            return false;
+        }
+        r.level = std::max(0, std::min(255, r.level));
+        out.runs_.push_back(r);
+    }
+    std::sort(out.runs_.begin(), out.runs_.end(), [](const BackgroundRun& a, const BackgroundRun& b)
+              { return a.y < b.y || (a.y == b.y && a.x0 < b.x0); });
+    return true;
+}
+
+// ─────────────────────────────────────────────────────────
+
+BackgroundLearner::BackgroundLearner(int width, int height, int brightLevel)
+    : width_(width), height_(height), brightLevel_(brightLevel),
+      max_(static_cast<size_t>(width) * height, 0),
+      count_(static_cast<size_t>(width) * height, 0)
+{
+}
+
+void BackgroundLearner::addFrame(const uint8_t* pixels)
+{
+    size_t n = max_.size();
+    for (size_t i = 0; i < n; i++)
+    {
+        uint8_t p = pixels[i];
+        if (p > max_[i]) max_[i] = p;
+        if (p > brightLevel_ && count_[i] < UINT16_MAX) ++count_[i];
+    }
+    ++frames_;
+}
+
+BackgroundMask BackgroundLearner::finish(float presence, int growPx, std::string& errorOut) const
+{
+    BackgroundMask mask;
+    if (frames_ == 0)
+    {
+        errorOut = "no frames collected";
+        return mask;
+    }
+
+    // 정적 픽셀만 남긴 밝기 맵 → growPx 만큼 max 필터 (넓힌 픽셀은 이웃의 밝기를 물려받음)
+    int     minCount = std::max(1, static_cast<int>(std::ceil(presence * frames_)));
+    cv::Mat levels(height_, width_, CV_8UC1, cv::Scalar(0));
+    for (int y = 0; y < height_; y++)
+    {
+        uint8_t* row = levels.ptr<uint8_t>(y);
+        size_t   off = static_cast<size_t>(y) * width_;
+        for (int x = 0; x < width_; x++)
+        {
+            if (count_[off + x] >= minCount) row[x] = std::max<uint8_t>(1, max_[off + x]);
+        }
+    }
+    if (growPx > 0)
+        cv::dilate(levels, levels, cv::getStructuringElement(cv::MORPH_RECT,
+                                                             cv::Size(2 * growPx + 1, 2 * growPx + 1)));
+
+    mask.width_  = width_;
+    mask.height_ = height_;
+    for (int y = 0; y < height_; y++)
+    {
+        const uint8_t* row = levels.ptr<uint8_t>(y);
+        for (int x = 0; x < width_; )
+        {
+            if (!row[x]) { ++x; continue; }
+            BackgroundRun r;
+            r.y  = y;
+            r.x0 = x;
+            while (x < width_ && row[x])
+            {
+                r.level = std::max(r.level, static_cast<int>(row[x]));
+                ++x;
+            }
+            r.x1 = x - 1;
+            if (mask.runs_.size() == BackgroundMask::MAX_RUNS)
+            {
+                errorOut = "too many bright regions (targets or lights moving during learning?)";
+                return BackgroundMask();
+            }
+            mask.runs_.push_back(r);
+        }
+    }
+    return mask;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ========== 학습된 정적 배경 억제 마스크 ==========
+// 스크린 베젤·조명 반사·핫 픽셀처럼 항상 같은 자리에 보이는 밝은 영역을 행 단위 run 으로 저장.
+// run 마다 학습 중 최대 밝기(level)를 기억해, 런타임에는 run 안에서 level + margin 이하인 픽셀만 0 으로
+// 만든다 (배경보다 확실히 밝은 실제 타깃은 반사 위를 지나가도 통과). 마스크가 희소해 비용은 run 픽셀 수에 비례.
+// setting.cfg: background=… (카메라 N ≥ 2 는 camN_background=…, N 은 1부터 번호)
+struct BackgroundRun
+{
+    int y     = 0;
+    int x0    = 0;          // 양 끝 포함
+    int x1    = 0;
+    int level = 0;          // 학습 중 run 안 최대 밝기
+};
+
+class BackgroundMask
+{
+public:
+    static constexpr size_t MAX_RUNS = 8192;   // 넘으면 학습 실패로 봄 (타깃/조명이 움직였을 가능성)
+
+    bool   empty() const { return runs_.empty(); }
+    int    width()  const { return width_; }
+    int    height() const { return height_; }
+    size_t runCount() const { return runs_.size(); }
+    size_t pixelCount() const;
+
+    // 프레임 크기가 학습 때와 같을 때만 적용
+    bool matches(int width, int height) const { return width == width_ && height == height_; }
+
+    // pixels (stride == width) 의 run 안 픽셀 중 level + margin 이하를 0 으로
+    void apply(uint8_t* pixels, int margin) const;
+
+    // 객체 모드용: (x, y) 를 반올림한 픽셀이 마스크 안이면 true
+    bool contains(float x, float y) const;
+
+    // "W,H;y,x0,x1,level;..." (빈 마스크는 빈 문자열)
+    std::string serialize() const;
+    static bool parse(const std::string& text, BackgroundMask& out);
+
+private:
+    friend class BackgroundLearner;
+
+    int width_  = 0;
+    int height_ = 0;
+    std::vector<BackgroundRun> runs_;   // (y, x0) 순 정렬
+};
+
+// ========== 배경 학습기 ==========
+// 타깃이 없는 상태에서 몇 초간 프레임을 넣으면 픽셀별 최대 밝기와 "밝았던 프레임 수"를 누적.
+// finish(): 전체 프레임의 presence 비율 이상 밝았던 픽셀 = 정적 배경 (지나가는 타깃은 제외),
+// growPx 만큼 넓혀 가장자리까지 덮은 뒤 run 으로 압축.
+class BackgroundLearner
+{
+public:
+    // brightLevel: 이 값보다 밝으면 "밝음" (보통 이진화 임계값 − margin)
+    BackgroundLearner(int width, int height, int brightLevel);
+
+    void addFrame(const uint8_t* pixels);      // stride == width
+    int  frames() const { return frames_; }
+    int  width()  const { return width_; }
+    int  height() const { return height_; }
+
+    // 실패 (프레임 없음 / run 수 초과) 시 빈 마스크 + errorOut
+    BackgroundMask finish(float presence, int growPx, std::string& errorOut) const;
+
+private:
+    int width_;
+    int height_;
+    int brightLevel_;
+    int frames_ = 0;
+    std::vector<uint8_t>  max_;
+    std::vector<uint16_t> count_;
+};
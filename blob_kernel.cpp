@@ -0,0 +1,296 @@
+#include "blob_kernel.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BLOB_KERNEL_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define BLOB_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BLOB_TARGET_AVX2
+#endif
+#else
+#define BLOB_KERNEL_X86 0
+#endif
+
+static constexpr int RADIUS = 3;             // 3×3 dilate 3회 → 반경 3
+static constexpr int TAPS   = 2 * RADIUS + 1;
+
+// ─────────────────────────────────────────────────────────
+//  이름 / 선택
+// ─────────────────────────────────────────────────────────
+
+const char* blobKernelName(BlobKernel k)
+{
+    switch (k)
+    {
+    case BlobKernel::Auto:   return "auto";
+    case BlobKernel::OpenCV: return "opencv";
+    case BlobKernel::Scalar: return "scalar";
+    case BlobKernel::SSE2:   return "sse2";
+    case BlobKernel::AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+bool parseBlobKernel(const char* name, BlobKernel& out)
+{
+    static const BlobKernel all[] = { BlobKernel::Auto, BlobKernel::OpenCV, BlobKernel::Scalar,
+                                      BlobKernel::SSE2, BlobKernel::AVX2 };
+    for (BlobKernel k : all)
+    {
+        if (strcmp(name, blobKernelName(k)) == 0) { out = k; return true; }
+    }
+    return false;
+}
+
+BlobKernel resolveBlobKernel(BlobKernel requested)
+{
+#if BLOB_KERNEL_X86
+    bool hasAvx2 = cv::checkHardwareSupport(CV_CPU_AVX2);
+    bool hasSse2 = cv::checkHardwareSupport(CV_CPU_SSE2);
+#else
+    bool hasAvx2 = false;
+    bool hasSse2 = false;
+#endif
+    switch (requested)
+    {
+    case BlobKernel::Auto:
+    case BlobKernel::AVX2:
+        if (hasAvx2) return BlobKernel::AVX2;
+        // fallthrough
+    case BlobKernel::SSE2:
+        if (hasSse2) return BlobKernel::SSE2;
+        return BlobKernel::Scalar;
+    case BlobKernel::OpenCV:
+    case BlobKernel::Scalar:
+        break;
+    }
+    return requested;
+}
+
+// ─────────────────────────────────────────────────────────
+//  가로 7-tap max (행 단위)
+// ─────────────────────────────────────────────────────────
+
+// 경계 포함 일반형: 영상 밖 픽셀은 무시
+static inline uint8_t hmaxClamped(const uint8_t* s, int width, int x)
+{
+    int lo = std::max(0, x - RADIUS);
+    int hi = std::min(width - 1, x + RADIUS);
+    uint8_t m = s[lo];
+    for (int i = lo + 1; i <= hi; i++) m = std::max(m, s[i]);
+    return m;
+}
+
+static void hmaxRowScalar(const uint8_t* s, uint8_t* d, int width)
+{
+    int x = 0;
+    for (; x < std::min(RADIUS, width); x++) d[x] = hmaxClamped(s, width, x);
+    for (; x < width - RADIUS; x++)
+    {
+        const uint8_t* p = s + x - RADIUS;
+        uint8_t m = std::max(std::max(std::max(p[0], p[1]), std::max(p[2], p[3])),
+                             std::max(std::max(p[4], p[5]), p[6]));
+        d[x] = m;
+    }
+    for (; x < width; x++) d[x] = hmaxClamped(s, width, x);
+}
+
+#if BLOB_KERNEL_X86
+static void hmaxRowSSE2(const uint8_t* s, uint8_t* d, int width)
+{
+    int x = 0;
+    for (; x < std::min(RADIUS, width); x++) d[x] = hmaxClamped(s, width, x);
+    for (; x + 16 + RADIUS <= width; x += 16)
+    {
+        const uint8_t* p = s + x - RADIUS;
+        __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        for (int k = 1; k < TAPS; k++)
+            m = _mm_max_epu8(m, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + k)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x), m);
+    }
+    for (; x < width; x++) d[x] = hmaxClamped(s, width, x);
+}
+
+BLOB_TARGET_AVX2
+static void hmaxRowAVX2(const uint8_t* s, uint8_t* d, int width)
+{
+    int x = 0;
+    for (; x < std::min(RADIUS, width); x++) d[x] = hmaxClamped(s, width, x);
+    for (; x + 32 + RADIUS <= width; x += 32)
+    {
+        const uint8_t* p = s + x - RADIUS;
+        __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        for (int k = 1; k < TAPS; k++)
+            m = _mm256_max_epu8(m, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + k)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + x), m);
+    }
+    for (; x < width; x++) d[x] = hmaxClamped(s, width, x);
+}
+#endif
+
+// ─────────────────────────────────────────────────────────
+//  세로 max (최대 7행) + threshold → 0/255
+// ─────────────────────────────────────────────────────────
+
+static void vmaxThreshRowScalar(const uint8_t* const* rows, int n, uint8_t* d, int width, uint8_t thresh)
+{
+    for (int x = 0; x < width; x++)
+    {
+        uint8_t m = rows[0][x];
+        for (int k = 1; k < n; k++) m = std::max(m, rows[k][x]);
+        d[x] = (m > thresh) ? 255 : 0;
+    }
+}
+
+#if BLOB_KERNEL_X86
+// m > thresh  ⇔  max(m, thresh+1) == m   (부호 없는 비교, thresh < 255)
+static void vmaxThreshRowSSE2(const uint8_t* const* rows, int n, uint8_t* d, int width, uint8_t thresh)
+{
+    const __m128i t1 = _mm_set1_epi8(static_cast<char>(thresh + 1));
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[0] + x));
+        for (int k = 1; k < n; k++)
+            m = _mm_max_epu8(m, _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + x)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x),
+                         _mm_cmpeq_epi8(_mm_max_epu8(m, t1), m));
+    }
+    for (; x < width; x++)
+    {
+        uint8_t m = rows[0][x];
+        for (int k = 1; k < n; k++) m = std::max(m, rows[k][x]);
+        d[x] = (m > thresh) ? 255 : 0;
+    }
+}
+
+BLOB_TARGET_AVX2
+static void vmaxThreshRowAVX2(const uint8_t* const* rows, int n, uint8_t* d, int width, uint8_t thresh)
+{
+    const __m256i t1 = _mm256_set1_epi8(static_cast<char>(thresh + 1));
+    int x = 0;
+    for (; x + 32 <= width; x += 32)
+    {
+        __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[0] + x));
+        for (int k = 1; k < n; k++)
+            m = _mm256_max_epu8(m, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k] + x)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + x),
+                            _mm256_cmpeq_epi8(_mm256_max_epu8(m, t1), m));
+    }
+    for (; x < width; x++)
+    {
+        uint8_t m = rows[0][x];
+        for (int k = 1; k < n; k++) m = std::max(m, rows[k][x]);
+        d[x] = (m > thresh) ? 255 : 0;
+    }
+}
+#endif
+
+// ─────────────────────────────────────────────────────────
+//  Public API
+// ─────────────────────────────────────────────────────────
+
+void dilateThreshold7x7(
+    const uint8_t*        src,
+    size_t                srcStep,
+    uint8_t*              dst,
+    size_t                dstStep,
+    int                   width,
+    int                   height,
+    uint8_t               thresh,
+    BlobKernel            impl,
+    std::vector<uint8_t>& scratch)
+{
+    if (width <= 0 || height <= 0) return;
+
+    // 255 초과 값은 없으므로 결과는 전부 0
+    if (thresh == 255)
+    {
+        for (int y = 0; y < height; y++) memset(dst + y * dstStep, 0, width);
+        return;
+    }
+
+    using HRow = void (*)(const uint8_t*, uint8_t*, int);
+    using VRow = void (*)(const uint8_t* const*, int, uint8_t*, int, uint8_t);
+    HRow hrow = hmaxRowScalar;
+    VRow vrow = vmaxThreshRowScalar;
+#if BLOB_KERNEL_X86
+    if (impl == BlobKernel::SSE2) { hrow = hmaxRowSSE2; vrow = vmaxThreshRowSSE2; }
+    if (impl == BlobKernel::AVX2) { hrow = hmaxRowAVX2; vrow = vmaxThreshRowAVX2; }
+#endif
+
+    // 가로 max 결과 7행 링 버퍼: 행 r 은 슬롯 r % 7
+    size_t need = static_cast<size_t>(TAPS) * width;
+    if (scratch.size() < need) scratch.resize(need);
+    uint8_t* ring = scratch.data();
+
+    const uint8_t* rows[TAPS];
+    int nextRow = 0;
+    for (int y = 0; y < height; y++)
+    {
+        int lo = std::max(0, y - RADIUS);
+        int hi = std::min(height - 1, y + RADIUS);
+        for (; nextRow <= hi; nextRow++)
+            hrow(src + nextRow * srcStep, ring + (nextRow % TAPS) * width, width);
+
+        int n = 0;
+        for (int r = lo; r <= hi; r++) rows[n++] = ring + (r % TAPS) * width;
+        vrow(rows, n, dst + y * dstStep, width, thresh);
+    }
+}
+
+bool verifyBlobKernel(BlobKernel impl)
+{
+    if (impl == BlobKernel::OpenCV) return true;
+
+    static const cv::Size sizes[] = { {1, 1}, {5, 3}, {7, 7}, {37, 19}, {67, 41}, {1280, 24} };
+    static const int      threshes[] = { 0, 200, 254 };
+
+    std::vector<uint8_t> scratch;
+    uint32_t seed = 12345u;
+    cv::Mat  kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+
+    for (const cv::Size& sz : sizes)
+    {
+        // 어두운 배경 + 드문 밝은 점 (경계 포함) — 실제 IR 영상과 유사한 분포
+        cv::Mat gray(sz.height, sz.width, CV_8UC1);
+        for (int y = 0; y < sz.height; y++)
+        {
+            uint8_t* row = gray.ptr<uint8_t>(y);
+            for (int x = 0; x < sz.width; x++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                uint32_t r = seed >> 24;
+                row[x] = static_cast<uint8_t>(r < 8 ? 180 + (seed >> 8) % 76 : (seed >> 8) % 120);
+            }
+        }
+
+        for (int t : threshes)
+        {
+            cv::Mat dilated, expected;
+            cv::dilate(gray, dilated, kernel, cv::Point(-1, -1), 3);
+            cv::threshold(dilated, expected, t, 255, cv::THRESH_BINARY);
+
+            cv::Mat actual(sz.height, sz.width, CV_8UC1);
+            dilateThreshold7x7(gray.data, gray.step, actual.data, actual.step,
+                               sz.width, sz.height, static_cast<uint8_t>(t), impl, scratch);
+
+            for (int y = 0; y < sz.height; y++)
+            {
+                if (memcmp(expected.ptr<uint8_t>(y), actual.ptr<uint8_t>(y), sz.width) != 0)
+                {
+                    std::cerr << "[BlobKernel] " << blobKernelName(impl) << " mismatch at "
+                              << sz.width << "x" << sz.height << " thresh=" << t
+                              << " row " << y << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
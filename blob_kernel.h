@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ========== Dilate + Threshold 융합 커널 ==========
+// 3×3 사각 커널 dilate 3회 == 7×7 max 필터 (영상 밖 픽셀은 무시, OpenCV 기본 border 와 동일).
+// 7×7 max 를 가로 running-max → 세로 max + 비교 의 분리형으로 계산하고,
+// 가로 결과는 7행 링 버퍼에만 두어 프레임을 한 번만 읽고 한 번만 쓴다.
+// 결과: max > thresh 이면 255, 아니면 0 (cv::threshold THRESH_BINARY 와 비트 단위 동일).
+enum class BlobKernel
+{
+    Auto   = 0,     // 지원되는 가장 빠른 구현 (AVX2 > SSE2 > Scalar)
+    OpenCV = 1,     // 기존 cv::dilate ×3 + cv::threshold
+    Scalar = 2,
+    SSE2   = 3,
+    AVX2   = 4
+};
+
+const char* blobKernelName(BlobKernel k);
+
+// 설정 문자열("auto", "opencv", "scalar", "sse2", "avx2") → BlobKernel. 알 수 없으면 false.
+bool parseBlobKernel(const char* name, BlobKernel& out);
+
+// Auto 를 실제 구현으로 해석하고, CPU 가 지원하지 않는 구현은 한 단계 낮은 구현으로 대체
+BlobKernel resolveBlobKernel(BlobKernel requested);
+
+// src → dst (0/255 마스크). src/dst 는 서로 다른 버퍼여야 함.
+// scratch 는 호출자가 보유해 재사용 (7 × width 바이트로 한 번만 확장됨).
+// impl 은 resolveBlobKernel() 결과여야 하며 OpenCV 는 여기서 처리하지 않음.
+void dilateThreshold7x7(
+    const uint8_t*        src,
+    size_t                srcStep,
+    uint8_t*              dst,
+    size_t                dstStep,
+    int                   width,
+    int                   height,
+    uint8_t               thresh,
+    BlobKernel            impl,
+    std::vector<uint8_t>& scratch);
+
+// 합성 영상으로 impl 결과를 cv::dilate ×3 + cv::threshold 와 비교 (비트 단위 동일하면 true)
+bool verifyBlobKernel(BlobKernel impl);
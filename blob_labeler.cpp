@@ -0,0 +1,172 @@
+#include "blob_labeler.h"
+#include <algorithm>
+#include <cstring>
+
+// ─────────────────────────────────────────────────────────
+//  중심점 모드 이름
+// ─────────────────────────────────────────────────────────
+
+const char* centroidModeName(CentroidMode m)
+{
+    switch (m)
+    {
+    case CentroidMode::Binary:   return "binary";
+    case CentroidMode::Weighted: return "weighted";
+    case CentroidMode::Gaussian: return "gaussian";
+    }
+    return "unknown";
+}
+
+bool parseCentroidMode(const char* name, CentroidMode& out)
+{
+    static const CentroidMode all[] = { CentroidMode::Binary, CentroidMode::Weighted,
+                                        CentroidMode::Gaussian };
+    for (CentroidMode m : all)
+    {
+        if (strcmp(name, centroidModeName(m)) == 0) { out = m; return true; }
+    }
+    return false;
+}
+
+// ─────────────────────────────────────────────────────────
+//  union-find (경로 압축 + 작은 인덱스를 루트로 → 래스터 순서 유지)
+// ─────────────────────────────────────────────────────────
+
+int BlobLabeler::findRoot(int i)
+{
+    int r = i;
+    while (runs_[r].parent != r) r = runs_[r].parent;
+    while (runs_[i].parent != r)
+    {
+        int next = runs_[i].parent;
+        runs_[i].parent = r;
+        i = next;
+    }
+    return r;
+}
+
+void BlobLabeler::unite(int a, int b)
+{
+    int ra = findRoot(a);
+    int rb = findRoot(b);
+    if (ra == rb) return;
+    if (rb < ra) std::swap(ra, rb);
+
+    Run&       dst = runs_[ra];
+    const Run& src = runs_[rb];
+    dst.area  += src.area;
+    dst.sumX  += src.sumX;
+    dst.sumY  += src.sumY;
+    dst.sumW  += src.sumW;
+    dst.sumWX += src.sumWX;
+    dst.sumWY += src.sumWY;
+    dst.bx0 = std::min(dst.bx0, src.bx0);
+    dst.by0 = std::min(dst.by0, src.by0);
+    dst.bx1 = std::max(dst.bx1, src.bx1);
+    dst.by1 = std::max(dst.by1, src.by1);
+    runs_[rb].parent = ra;
+}
+
+// 다음 전경 픽셀 위치 (없으면 width). 배경은 8바이트 단위로 건너뜀.
+static inline int skipZeros(const uint8_t* row, int x, int width)
+{
+    while (x + 8 <= width)
+    {
+        uint64_t v;
+        memcpy(&v, row + x, 8);
+        if (v != 0) break;
+        x += 8;
+    }
+    while (x < width && row[x] == 0) x++;
+    return x;
+}
+
+static inline int skipOnes(const uint8_t* row, int x, int width)
+{
+    while (x < width && row[x] != 0) x++;
+    return x;
+}
+
+// ─────────────────────────────────────────────────────────
+//  Public API
+// ─────────────────────────────────────────────────────────
+
+void BlobLabeler::label(const uint8_t*     mask,
+                        size_t             maskStep,
+                        int                width,
+                        int                height,
+                        const uint8_t*     gray,
+                        size_t             grayStep,
+                        uint8_t            weightFloor,
+                        std::vector<Blob>& out)
+{
+    runs_.clear();
+    out.clear();
+
+    int prevBegin = 0, prevEnd = 0;     // 이전 행 run 인덱스 범위 [prevBegin, prevEnd)
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* mrow = mask + y * maskStep;
+        const uint8_t* grow = gray ? gray + y * grayStep : nullptr;
+
+        int rowBegin = static_cast<int>(runs_.size());
+        int j        = prevBegin;       // 이전 행에서 겹침 후보 시작점 (x 증가 순으로 전진)
+
+        int x = skipZeros(mrow, 0, width);
+        while (x < width)
+        {
+            int xEnd = skipOnes(mrow, x, width);   // [x, xEnd)
+            int len  = xEnd - x;
+
+            Run r;
+            r.x0 = x; r.x1 = xEnd - 1; r.y = y;
+            r.parent = static_cast<int>(runs_.size());
+            r.area   = len;
+            r.sumX   = static_cast<int64_t>(r.x0 + r.x1) * len / 2;
+            r.sumY   = static_cast<int64_t>(y) * len;
+            r.sumW = r.sumWX = r.sumWY = 0;
+            if (grow)
+            {
+                for (int i = r.x0; i <= r.x1; i++)
+                {
+                    int64_t g = static_cast<int64_t>(grow[i]) - weightFloor;
+                    if (g <= 0) continue;
+                    r.sumW  += g;
+                    r.sumWX += g * i;
+                }
+                r.sumWY = r.sumW * y;
+            }
+            r.bx0 = r.x0; r.by0 = y; r.bx1 = r.x1; r.by1 = y;
+            runs_.push_back(r);
+            int cur = r.parent;
+
+            // 8-연결: 이전 행 run 중 [x0-1, x1+1] 과 겹치는 것과 병합
+            while (j < prevEnd && runs_[j].x1 < r.x0 - 1) j++;
+            for (int k = j; k < prevEnd && runs_[k].x0 <= r.x1 + 1; k++)
+                unite(cur, k);
+
+            x = skipZeros(mrow, xEnd, width);
+        }
+
+        prevBegin = rowBegin;
+        prevEnd   = static_cast<int>(runs_.size());
+    }
+
+    // 루트 run 하나당 블롭 하나 (루트 = 블롭의 첫 run → 래스터 순서)
+    for (size_t i = 0; i < runs_.size(); i++)
+    {
+        const Run& r = runs_[i];
+        if (r.parent != static_cast<int>(i)) continue;
+
+        Blob b;
+        b.area  = static_cast<int>(r.area);
+        b.cx    = static_cast<float>(static_cast<double>(r.sumX) / r.area);
+        b.cy    = static_cast<float>(static_cast<double>(r.sumY) / r.area);
+        b.x0    = r.bx0; b.y0 = r.by0;
+        b.x1    = r.bx1; b.y1 = r.by1;
+        b.sumW  = r.sumW;
+        b.sumWX = r.sumWX;
+        b.sumWY = r.sumWY;
+        out.push_back(b);
+    }
+}
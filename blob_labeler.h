@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ========== 중심점 계산 방식 ==========
+enum class CentroidMode
+{
+    Binary   = 0,   // 마스크 픽셀 무게중심
+    Weighted = 1,   // 블롭 내부 원본 밝기(- weightFloor) 가중 무게중심
+    Gaussian = 2    // Weighted + 작은 블롭은 2D Gaussian(log 2차식) 피팅으로 보정
+};
+
+const char* centroidModeName(CentroidMode m);
+bool        parseCentroidMode(const char* name, CentroidMode& out);
+
+// ========== 연결 요소(블롭) 통계 ==========
+struct Blob
+{
+    float   cx   = 0.f;     // 마스크 픽셀 무게중심 (sub-pixel, 픽셀 중심 = 정수 좌표)
+    float   cy   = 0.f;
+    int     area = 0;       // 픽셀 수
+    int     x0 = 0, y0 = 0; // 바운딩 박스 (양 끝 포함)
+    int     x1 = 0, y1 = 0;
+
+    // gray 가 주어졌을 때만 채워짐: Σw, Σw·x, Σw·y  (w = max(0, g - weightFloor))
+    int64_t sumW  = 0;
+    int64_t sumWX = 0;
+    int64_t sumWY = 0;
+};
+
+// ========== Run-length 연결 요소 라벨러 ==========
+// 마스크를 한 번만 훑으며 행마다 run(연속 전경 구간)을 뽑고, 이전 행 run 과
+// 8-연결로 union-find 병합하면서 면적/Σx/Σy(/밝기 가중 합)를 누적한다.
+// 윤곽선 점 리스트나 라벨 영상을 만들지 않으며, 내부 벡터는 재사용된다.
+//
+// findContours(RETR_EXTERNAL) 와의 차이: 다른 블롭의 구멍 안에 있는 블롭도 별도로 보고된다
+// (dilate 된 IR 점에서는 사실상 발생하지 않음).
+class BlobLabeler
+{
+public:
+    // mask: 0 = 배경, 그 외 = 전경. gray 가 nullptr 이 아니면 밝기 가중 합도 누적
+    // (가중치는 g - weightFloor, 음수는 0 — dilate 로 넓어진 어두운 가장자리의 편향 제거).
+    // out 은 clear 후 래스터 순서(첫 run 기준)로 채워짐.
+    void label(const uint8_t*     mask,
+               size_t             maskStep,
+               int                width,
+               int                height,
+               const uint8_t*     gray,
+               size_t             grayStep,
+               uint8_t            weightFloor,
+               std::vector<Blob>& out);
+
+    // 할당 추적용: 내부 run 버퍼 capacity
+    size_t runCapacity() const { return runs_.capacity(); }
+
+private:
+    struct Run
+    {
+        int     x0, x1, y;
+        int     parent;
+        // 루트 run 에만 유효한 누적 통계
+        int64_t area, sumX, sumY;
+        int64_t sumW, sumWX, sumWY;
+        int     bx0, by0, bx1, by1;
+    };
+
+    int  findRoot(int i);
+    void unite(int a, int b);
+
+    std::vector<Run> runs_;
+};
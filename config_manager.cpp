@@ -1,37 +1,59 @@
 #include "config_manager.h"
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <cctype>
 #include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 // ─────────────────────────────────────────────────────────
 
 std::string getExeDir()
 {
+#ifdef _WIN32
     char path[MAX_PATH] = {};
     GetModuleFileNameA(nullptr, path, MAX_PATH);
     std::string s(path);
+#else
+    char path[4096] = {};
+    ssize_t n = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    std::string s(n > 0 ? path : "");
+#endif
     size_t pos = s.find_last_of("\\/");
-    return (pos != std::string::npos) ? s.substr(0, pos + 1) : ".\\";
+    return (pos != std::string::npos) ? s.substr(0, pos + 1) : "./";
 }
 
 // ─────────────────────────────────────────────────────────
 
-bool saveConfig(const AppSettings& settings, const std::vector<cv::Point2f>& corners)
+bool saveConfig(const AppSettings& settings, const CameraCorners& corners,
+                const CameraBackgrounds& backgrounds)
 {
     // conf/ 폴더 생성 (이미 있으면 무시)
     std::string confDir = getExeDir() + "conf";
-    if (!CreateDirectoryA(confDir.c_str(), nullptr))
+    std::error_code ec;
+    std::filesystem::create_directories(confDir, ec);
+    if (ec)
     {
-        if (GetLastError() != ERROR_ALREADY_EXISTS)
-        {
-            std::cerr << "[Config] Cannot create directory: " << confDir
-                      << "  (Error " << GetLastError() << ")" << std::endl;
-            return false;
-        }
+        std::cerr << "[Config] Cannot create directory: " << confDir
+                  << "  (" << ec.message() << ")" << std::endl;
+        return false;
     }
 
-    std::string filePath = confDir + "\\setting.cfg";
+    std::string filePath = confDir + "/setting.cfg";
     std::ofstream f(filePath);
     if (!f.is_open())
     {
@@ -45,12 +67,89 @@ bool saveConfig(const AppSettings& settings, const std::vector<cv::Point2f>& cor
     f << "target_height=" << settings.targetHeight << "\n";
     f << "exposure="      << settings.exposure     << "\n";
     f << "udp_fps="       << settings.udpFps       << "\n";
-    f << "corner_count="  << corners.size()        << "\n";
+    f << "blob_kernel="   << blobKernelName(settings.blobKernel) << "\n";
+    f << "roi_detection=" << (settings.roiDetection ? 1 : 0) << "\n";
+    f << "roi_polygon_mask=" << (settings.roiPolygonMask ? 1 : 0) << "\n";
+    f << "centroid_mode=" << centroidModeName(settings.centroidMode) << "\n";
+    f << "centroid_weight_floor=" << settings.centroidWeightFloor << "\n";
+    f << "gaussian_max_area=" << settings.gaussianMaxArea << "\n";
+    f << "udp_decimals="  << settings.udpDecimals  << "\n";
+    f << "udp_format="    << packetFormatName(settings.udpFormat) << "\n";
+    f << "udp_send_area=" << (settings.udpSendArea ? 1 : 0) << "\n";
+    f << "udp_send_mode=" << udpSendModeName(settings.udpSendMode) << "\n";
+    f << "udp_min_interval_us=" << settings.udpMinIntervalUs << "\n";
+    f << "udp_keepalive_ms=" << settings.udpKeepaliveMs << "\n";
+    f << "udp_targets="   << settings.udpTargets   << "\n";
+    f << "udp_multicast_ttl=" << settings.udpMulticastTtl << "\n";
+    f << "tracking="      << (settings.tracking ? 1 : 0) << "\n";
+    f << "track_gate_px=" << settings.trackGatePx  << "\n";
+    f << "track_max_missed=" << settings.trackMaxMissed << "\n";
+    f << "track_accel_noise=" << settings.trackAccelNoise << "\n";
+    f << "track_meas_noise=" << settings.trackMeasNoise << "\n";
+    f << "track_predict_ms=" << settings.trackPredictMs << "\n";
+    f << "udp_extrapolate_ms=" << settings.udpExtrapolateMs << "\n";
+    f << "lens_undistort=" << (settings.lens.enabled ? 1 : 0) << "\n";
+    f.precision(10);    // 렌즈 계수는 기본 6자리로는 부족
+    f << "lens_fx=" << settings.lens.fx << "\n";
+    f << "lens_fy=" << settings.lens.fy << "\n";
+    f << "lens_cx=" << settings.lens.cx << "\n";
+    f << "lens_cy=" << settings.lens.cy << "\n";
+    f << "lens_k1=" << settings.lens.k1 << "\n";
+    f << "lens_k2=" << settings.lens.k2 << "\n";
+    f << "lens_p1=" << settings.lens.p1 << "\n";
+    f << "lens_p2=" << settings.lens.p2 << "\n";
+    f << "lens_k3=" << settings.lens.k3 << "\n";
+    f << "fiducial_cols=" << settings.fiducial.cols << "\n";
+    f << "fiducial_rows=" << settings.fiducial.rows << "\n";
+    f << "fiducial_margin_px=" << settings.fiducial.marginPx << "\n";
+    f << "fiducial_ransac_px=" << settings.fiducial.ransacPx << "\n";
+    f << "camera_count="  << settings.cameraCount  << "\n";
+    f << "merge_radius_px=" << settings.mergeRadiusPx << "\n";
+    f << "merge_max_age_ms=" << settings.mergeMaxAgeMs << "\n";
+    f << "object_mode="   << (settings.objectMode ? 1 : 0) << "\n";
+    f << "object_threshold=" << settings.objectThreshold << "\n";
+    f << "object_preview_every=" << settings.objectPreviewEvery << "\n";
+    f << "threshold="     << settings.levels.threshold << "\n";
+    f << "auto_threshold=" << (settings.levels.autoThreshold ? 1 : 0) << "\n";
+    f << "threshold_min=" << settings.levels.thresholdMin << "\n";
+    f << "threshold_max=" << settings.levels.thresholdMax << "\n";
+    f << "threshold_bg_percentile=" << settings.levels.backgroundPercentile << "\n";
+    f << "threshold_ratio=" << settings.levels.thresholdRatio << "\n";
+    f << "threshold_min_contrast=" << settings.levels.minContrast << "\n";
+    f << "threshold_hysteresis=" << settings.levels.hysteresis << "\n";
+    f << "auto_exposure=" << (settings.levels.autoExposure ? 1 : 0) << "\n";
+    f << "exposure_min="  << settings.levels.exposureMin << "\n";
+    f << "exposure_max="  << settings.levels.exposureMax << "\n";
+    f << "exposure_target_peak=" << settings.levels.targetPeak << "\n";
+    f << "exposure_peak_band=" << settings.levels.peakBand << "\n";
+    f << "exposure_step=" << settings.levels.exposureStep << "\n";
+    f << "exposure_interval=" << settings.levels.exposureInterval << "\n";
+    f << "level_sample_step=" << settings.levels.sampleStep << "\n";
+    f << "background_suppression=" << (settings.backgroundSuppression ? 1 : 0) << "\n";
+    f << "background_margin=" << settings.backgroundMargin << "\n";
+    f << "background_grow_px=" << settings.backgroundGrowPx << "\n";
+    f << "background_learn_ms=" << settings.backgroundLearnMs << "\n";
+    f << "background_presence=" << settings.backgroundPresence << "\n";
+    f << "record_chunk_frames=" << settings.recordChunkFrames << "\n";
+    f << "record_buffers=" << settings.recordBuffers << "\n";
+    f << "record_lz4=" << (settings.recordLz4 ? 1 : 0) << "\n";
 
-    for (size_t i = 0; i < corners.size(); i++)
+    for (size_t cam = 0; cam < corners.size(); cam++)
+    {
+        std::string prefix = cam == 0 ? "" : "cam" + std::to_string(cam + 1) + "_";
+        f << prefix << "corner_count=" << corners[cam].size() << "\n";
+        for (size_t i = 0; i < corners[cam].size(); i++)
+        {
+            // 자동 캘리브레이션 코너는 sub-pixel 이므로 소수 그대로 저장 (클릭 코너는 정수)
+            f << prefix << "corner" << i << "_x=" << corners[cam][i].x << "\n";
+            f << prefix << "corner" << i << "_y=" << corners[cam][i].y << "\n";
+        }
+    }
+    for (size_t cam = 0; cam < backgrounds.size(); cam++)
     {
-        f << "corner" << i << "_x=" << static_cast<int>(corners[i].x) << "\n";
-        f << "corner" << i << "_y=" << static_cast<int>(corners[i].y) << "\n";
+        if (backgrounds[cam].empty()) continue;
+        std::string prefix = cam == 0 ? "" : "cam" + std::to_string(cam + 1) + "_";
+        f << prefix << "background=" << backgrounds[cam].serialize() << "\n";
     }
 
     std::cout << "[Config] Saved to: " << filePath << std::endl;
@@ -59,15 +158,17 @@ bool saveConfig(const AppSettings& settings, const std::vector<cv::Point2f>& cor
 
 // ─────────────────────────────────────────────────────────
 
-bool loadConfig(AppSettings& settings, std::vector<cv::Point2f>& corners)
+bool loadConfig(AppSettings& settings, CameraCorners& corners, CameraBackgrounds& backgrounds)
 {
-    std::string filePath = getExeDir() + "conf\\setting.cfg";
+    std::string filePath = getExeDir() + "conf/setting.cfg";
     std::ifstream f(filePath);
     if (!f.is_open()) return false;
 
-    corners.clear();
-    int   cornerCount = 0;
-    float cx[4] = {}, cy[4] = {};
+    corners.assign(1, {});
+    backgrounds.assign(MAX_CAMERAS, BackgroundMask());
+    int   cornerCount[MAX_CAMERAS] = {};
+    float cx[MAX_CAMERAS][4] = {}, cy[MAX_CAMERAS][4] = {};
+    int   lastCamera = 0;
 
     std::string line;
     while (std::getline(f, line))
@@ -82,13 +183,113 @@ bool loadConfig(AppSettings& settings, std::vector<cv::Point2f>& corners)
 
         try
         {
-            if      (key == "ip")            { strncpy_s(settings.ipAddress, sizeof(settings.ipAddress), val.c_str(), _TRUNCATE); }
+            // 카메라 N (1부터, 로그·1~N 키·_camN 녹화 접미사와 같은 번호) 코너/배경:
+            // camN_corner*, camN_background → 인덱스 N-1, 접두사를 떼고 아래 파싱 공유
+            int cam = 0;
+            if (key.size() > 5 && key.compare(0, 3, "cam") == 0 && isdigit(static_cast<unsigned char>(key[3])))
+            {
+                size_t under = key.find('_', 3);
+                if (under == std::string::npos) continue;
+                cam = std::stoi(key.substr(3, under - 3)) - 1;
+                key = key.substr(under + 1);
+                if (cam < 0 || cam >= MAX_CAMERAS ||
+                    (key.compare(0, 6, "corner") != 0 && key != "background")) continue;
+                lastCamera = std::max(lastCamera, cam);
+            }
+
+            if      (key == "ip")            { snprintf(settings.ipAddress, sizeof(settings.ipAddress), "%s", val.c_str()); }
             else if (key == "port")          { int p = std::stoi(val); if (p > 0 && p <= 65535) settings.port = p; }
             else if (key == "target_width")  { int w = std::stoi(val); if (w > 0) settings.targetWidth  = w; }
             else if (key == "target_height") { int h = std::stoi(val); if (h > 0) settings.targetHeight = h; }
             else if (key == "exposure")      { int e = std::stoi(val); settings.exposure = std::max(0, std::min(7500, e)); }
             else if (key == "udp_fps")       { int f2 = std::stoi(val); settings.udpFps = std::max(1, std::min(1000, f2)); }
-            else if (key == "corner_count")  { cornerCount = std::stoi(val); }
+            else if (key == "blob_kernel")
+            {
+                if (!parseBlobKernel(val.c_str(), settings.blobKernel))
+                    std::cerr << "[Config] Unknown blob_kernel: " << val << std::endl;
+            }
+            else if (key == "roi_detection")    { settings.roiDetection   = std::stoi(val) != 0; }
+            else if (key == "roi_polygon_mask") { settings.roiPolygonMask = std::stoi(val) != 0; }
+            else if (key == "centroid_mode")
+            {
+                if (!parseCentroidMode(val.c_str(), settings.centroidMode))
+                    std::cerr << "[Config] Unknown centroid_mode: " << val << std::endl;
+            }
+            else if (key == "centroid_weight_floor") { settings.centroidWeightFloor = std::max(0, std::min(254, std::stoi(val))); }
+            else if (key == "gaussian_max_area")     { settings.gaussianMaxArea     = std::max(0, std::stoi(val)); }
+            else if (key == "udp_decimals")          { settings.udpDecimals         = std::max(0, std::min(3, std::stoi(val))); }
+            else if (key == "udp_format")
+            {
+                if (!parsePacketFormat(val.c_str(), settings.udpFormat))
+                    std::cerr << "[Config] Unknown udp_format: " << val << std::endl;
+            }
+            else if (key == "udp_send_area")         { settings.udpSendArea         = std::stoi(val) != 0; }
+            else if (key == "udp_send_mode")
+            {
+                if (!parseUdpSendMode(val.c_str(), settings.udpSendMode))
+                    std::cerr << "[Config] Unknown udp_send_mode: " << val << std::endl;
+            }
+            else if (key == "udp_min_interval_us")   { settings.udpMinIntervalUs    = std::max(0, std::stoi(val)); }
+            else if (key == "udp_keepalive_ms")      { settings.udpKeepaliveMs      = std::max(0, std::stoi(val)); }
+            else if (key == "udp_targets")           { snprintf(settings.udpTargets, sizeof(settings.udpTargets), "%s", val.c_str()); }
+            else if (key == "udp_multicast_ttl")     { settings.udpMulticastTtl     = std::max(0, std::min(255, std::stoi(val))); }
+            else if (key == "tracking")              { settings.tracking            = std::stoi(val) != 0; }
+            else if (key == "track_gate_px")         { settings.trackGatePx         = std::max(1.f, std::stof(val)); }
+            else if (key == "track_max_missed")      { settings.trackMaxMissed      = std::max(0, std::stoi(val)); }
+            else if (key == "track_accel_noise")     { settings.trackAccelNoise     = std::max(1.f, std::stof(val)); }
+            else if (key == "track_meas_noise")      { settings.trackMeasNoise      = std::max(0.01f, std::stof(val)); }
+            else if (key == "track_predict_ms")      { settings.trackPredictMs      = std::max(0.f, std::min(100.f, std::stof(val))); }
+            else if (key == "lens_undistort")        { settings.lens.enabled        = std::stoi(val) != 0; }
+            else if (key == "lens_fx")               { settings.lens.fx             = std::stod(val); }
+            else if (key == "lens_fy")               { settings.lens.fy             = std::stod(val); }
+            else if (key == "lens_cx")               { settings.lens.cx             = std::stod(val); }
+            else if (key == "lens_cy")               { settings.lens.cy             = std::stod(val); }
+            else if (key == "lens_k1")               { settings.lens.k1             = std::stod(val); }
+            else if (key == "lens_k2")               { settings.lens.k2             = std::stod(val); }
+            else if (key == "lens_p1")               { settings.lens.p1             = std::stod(val); }
+            else if (key == "lens_p2")               { settings.lens.p2             = std::stod(val); }
+            else if (key == "lens_k3")               { settings.lens.k3             = std::stod(val); }
+            else if (key == "fiducial_cols")         { settings.fiducial.cols       = std::max(2, std::stoi(val)); }
+            else if (key == "fiducial_rows")         { settings.fiducial.rows       = std::max(2, std::stoi(val)); }
+            else if (key == "fiducial_margin_px")    { settings.fiducial.marginPx   = std::max(0.f, std::stof(val)); }
+            else if (key == "fiducial_ransac_px")    { settings.fiducial.ransacPx   = std::max(0.1f, std::stof(val)); }
+            else if (key == "udp_extrapolate_ms")    { settings.udpExtrapolateMs    = std::max(0, std::min(200, std::stoi(val))); }
+            else if (key == "camera_count")          { settings.cameraCount         = std::max(1, std::min(MAX_CAMERAS, std::stoi(val))); }
+            else if (key == "merge_radius_px")       { settings.mergeRadiusPx       = std::max(0.f, std::stof(val)); }
+            else if (key == "merge_max_age_ms")      { settings.mergeMaxAgeMs       = std::max(1, std::stoi(val)); }
+            else if (key == "object_mode")           { settings.objectMode          = std::stoi(val) != 0; }
+            else if (key == "object_threshold")      { settings.objectThreshold     = std::max(1, std::min(255, std::stoi(val))); }
+            else if (key == "object_preview_every")  { settings.objectPreviewEvery  = std::max(0, std::stoi(val)); }
+            else if (key == "threshold")             { settings.levels.threshold    = std::max(1, std::min(254, std::stoi(val))); }
+            else if (key == "auto_threshold")        { settings.levels.autoThreshold = std::stoi(val) != 0; }
+            else if (key == "threshold_min")         { settings.levels.thresholdMin = std::max(1, std::min(254, std::stoi(val))); }
+            else if (key == "threshold_max")         { settings.levels.thresholdMax = std::max(1, std::min(254, std::stoi(val))); }
+            else if (key == "threshold_bg_percentile") { settings.levels.backgroundPercentile = std::max(50.f, std::min(100.f, std::stof(val))); }
+            else if (key == "threshold_ratio")       { settings.levels.thresholdRatio = std::max(0.05f, std::min(0.95f, std::stof(val))); }
+            else if (key == "threshold_min_contrast") { settings.levels.minContrast = std::max(1, std::min(200, std::stoi(val))); }
+            else if (key == "threshold_hysteresis")  { settings.levels.hysteresis   = std::max(0, std::stoi(val)); }
+            else if (key == "auto_exposure")         { settings.levels.autoExposure = std::stoi(val) != 0; }
+            else if (key == "exposure_min")          { settings.levels.exposureMin  = std::max(1, std::stoi(val)); }
+            else if (key == "exposure_max")          { settings.levels.exposureMax  = std::max(1, std::stoi(val)); }
+            else if (key == "exposure_target_peak")  { settings.levels.targetPeak   = std::max(1, std::min(255, std::stoi(val))); }
+            else if (key == "exposure_peak_band")    { settings.levels.peakBand     = std::max(1, std::stoi(val)); }
+            else if (key == "exposure_step")         { settings.levels.exposureStep = std::max(0.01f, std::min(0.9f, std::stof(val))); }
+            else if (key == "exposure_interval")     { settings.levels.exposureInterval = std::max(1, std::stoi(val)); }
+            else if (key == "background_suppression") { settings.backgroundSuppression = std::stoi(val) != 0; }
+            else if (key == "background_margin")     { settings.backgroundMargin    = std::max(0, std::min(255, std::stoi(val))); }
+            else if (key == "background_grow_px")    { settings.backgroundGrowPx    = std::max(0, std::min(8, std::stoi(val))); }
+            else if (key == "background_learn_ms")   { settings.backgroundLearnMs   = std::max(100, std::stoi(val)); }
+            else if (key == "background_presence")   { settings.backgroundPresence  = std::max(0.05f, std::min(1.f, std::stof(val))); }
+            else if (key == "record_chunk_frames")   { settings.recordChunkFrames   = std::max(1, std::min(64, std::stoi(val))); }
+            else if (key == "record_buffers")        { settings.recordBuffers       = std::max(2, std::min(32, std::stoi(val))); }
+            else if (key == "record_lz4")            { settings.recordLz4           = std::stoi(val) != 0; }
+            else if (key == "background")
+            {
+                if (!BackgroundMask::parse(val, backgrounds[cam]))
+                    std::cerr << "[Config] Invalid background mask for camera " << cam + 1 << std::endl;
+            }
+            else if (key == "level_sample_step")     { settings.levels.sampleStep   = std::max(1, std::min(64, std::stoi(val))); }
+            else if (key == "corner_count")  { cornerCount[cam] = std::stoi(val); }
             else if (key.size() > 7 && key.substr(0, 6) == "corner")
             {
                 // 형식: corner{i}_x  또는  corner{i}_y
@@ -99,8 +300,8 @@ bool loadConfig(AppSettings& settings, std::vector<cv::Point2f>& corners)
                     std::string axis = key.substr(under + 1);
                     if (idx >= 0 && idx < 4)
                     {
-                        if      (axis == "x") cx[idx] = std::stof(val);
-                        else if (axis == "y") cy[idx] = std::stof(val);
+                        if      (axis == "x") cx[cam][idx] = std::stof(val);
+                        else if (axis == "y") cy[cam][idx] = std::stof(val);
                     }
                 }
             }
@@ -111,15 +312,27 @@ bool loadConfig(AppSettings& settings, std::vector<cv::Point2f>& corners)
         }
     }
 
-    int n = std::min(cornerCount, 4);
-    for (int i = 0; i < n; i++)
-        corners.emplace_back(cx[i], cy[i]);
+    corners.resize(lastCamera + 1);
+    backgrounds.resize(lastCamera + 1);
+    for (int cam = 0; cam <= lastCamera; cam++)
+    {
+        int n = std::min(cornerCount[cam], 4);
+        for (int i = 0; i < n; i++)
+            corners[cam].emplace_back(cx[cam][i], cy[cam][i]);
+    }
 
     std::cout << "[Config] Loaded: IP=" << settings.ipAddress
               << "  Port=" << settings.port
               << "  " << settings.targetWidth << "x" << settings.targetHeight
               << "  Exposure=" << settings.exposure
               << "  UDP_FPS=" << settings.udpFps
-              << "  Corners=" << corners.size() << std::endl;
+              << "  BlobKernel=" << blobKernelName(settings.blobKernel)
+              << "  Centroid=" << centroidModeName(settings.centroidMode)
+              << "  Tracking=" << (settings.tracking ? 1 : 0)
+              << "  Cameras=" << settings.cameraCount
+              << "  ObjectMode=" << (settings.objectMode ? 1 : 0)
+              << "  Threshold=" << settings.levels.threshold << (settings.levels.autoThreshold ? "(auto)" : "")
+              << "  AutoExposure=" << (settings.levels.autoExposure ? 1 : 0)
+              << "  Corners=" << corners[0].size() << std::endl;
     return true;
 }
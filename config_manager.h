@@ -1,17 +1,26 @@
 #pragma once
 
+#include "background_mask.h"
 #include "settings.h"
 #include <opencv2/core/types.hpp>
 #include <vector>
 #include <string>
 
-// 실행 파일이 위치한 디렉토리 반환 (끝에 '\' 포함)
+// 실행 파일이 위치한 디렉토리 반환 (끝에 경로 구분자 포함)
 std::string getExeDir();
 
-// 모든 설정값과 코너 포인트를 <exeDir>/conf/setting.cfg 에 저장
+// 카메라별 4점 코너 (인덱스 = 카메라 번호 - 1). 카메라 1 은 기존 corner* 키,
+// 카메라 N ≥ 2 는 camN_corner* 키로 저장 (N 은 로그·1~N 키·_camN 녹화 접미사와 같은 1부터 번호).
+using CameraCorners = std::vector<std::vector<cv::Point2f>>;
+
+// 카메라별 학습 배경 마스크 (코너와 같은 인덱스/접두사 규칙, 키 background / camN_background)
+using CameraBackgrounds = std::vector<BackgroundMask>;
+
+// 모든 설정값과 코너 포인트, 배경 마스크를 <exeDir>/conf/setting.cfg 에 저장
 // conf/ 폴더가 없으면 자동 생성. 성공 시 true 반환.
-bool saveConfig(const AppSettings& settings, const std::vector<cv::Point2f>& corners);
+bool saveConfig(const AppSettings& settings, const CameraCorners& corners,
+                const CameraBackgrounds& backgrounds);
 
-// <exeDir>/conf/setting.cfg 에서 설정값과 코너 포인트를 불러옴
-// 파일이 없거나 파싱 오류 시 false 반환.
-bool loadConfig(AppSettings& settings, std::vector<cv::Point2f>& corners);
+// <exeDir>/conf/setting.cfg 에서 설정값과 코너 포인트, 배경 마스크를 불러옴.
+// corners / backgrounds 는 최소 1개 (카메라 1). 파일이 없거나 파싱 오류 시 false 반환.
+bool loadConfig(AppSettings& settings, CameraCorners& corners, CameraBackgrounds& backgrounds);
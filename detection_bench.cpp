@@ -0,0 +1,379 @@
+/*
+ * 검출 파이프라인 벤치마크 (카메라 불필요, 합성 IR 영상 사용)
+ *
+ * Flex 13 해상도(1280×1024)와 그보다 큰 해상도에서 블롭 개수(0~64)·크기·노이즈를 바꿔 가며
+ * 합성 8-bit IR 프레임을 만들고, 다음 단계를 각각 따로 측정한다:
+ *   - detect  : FrameProcessor::detect()  (Dilate+Threshold + 라벨링 + 중심점 변환)
+ *   - render  : FrameProcessor::render()  (왼쪽 패널 + remap 테이블 warp 미리보기)
+ *   - process : FrameProcessor::process() (detect + render, 기존 processFrame 경로)
+ *   - text    : 텍스트 UDP 패킷 직렬화   (formatTextPacket)
+ *   - binary  : IRTP 바이너리 패킷 직렬화 (encodeBinaryPacket)
+ *
+ * 단계마다 ns/frame (p50/p99/mean), 처리량(frame/s, MPix/s), 호출당 힙 할당 수(operator new, 총합도 함께)와
+ * FrameProcessor 버퍼 재할당 수를 출력한다. 호출당 값은 총합을 총 호출 수로 나눈 실수라 잘리지 않는다.
+ *
+ * CI 용 (ctest 가 --quick 으로 실행): CPU 가 지원하는 융합 커널(scalar/sse2/avx2) 중 하나라도
+ * verifyBlobKernel() 비트 단위 검증에 실패하거나, warm-up 이후 FrameProcessor 버퍼 재할당이 한 번이라도
+ * 있거나, --max-detect-us 로 준 detect p50 한도를 넘으면 종료 코드 1. (런타임은 검증 실패 시 OpenCV 로
+ * 대체할 뿐이라 여기서 잡지 않으면 깨진 SIMD 커널이 조용히 통과한다.)
+ *
+ * 사용법:
+ *   DetectionBench [--seconds N] [--quick] [--threads N] [--kernel auto|opencv|scalar|sse2|avx2]
+ *                  [--centroid binary|weighted|gaussian] [--max-detect-us N]
+ */
+
+#include "blob_kernel.h"
+#include "frame_processor.h"
+#include "homography.h"
+#include "packet_format.h"
+#include "settings.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// ========== 전역 할당 카운터 ==========
+static std::atomic<long> g_allocations{0};
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+using Clock = std::chrono::steady_clock;
+
+// ========== 합성 장면 ==========
+struct SceneSpec
+{
+    int   width;
+    int   height;
+    int   blobs;            // 프레임당 블롭 수 (0~64)
+    float minSigma;         // 블롭 Gaussian 반경 범위 (px)
+    float maxSigma;
+    float noiseSigma;       // 배경 노이즈 표준편차 (밝기)
+    int   hotPixels;        // 프레임당 고립된 포화 픽셀 수
+};
+
+// 프레임 풀 크기: 블롭 위치가 매 프레임 바뀌도록 순환 (캐시에 한 장만 올라가는 것도 방지)
+static constexpr int FRAME_POOL = 8;
+
+// 배경 (밝기 10 ± noise) 위에 Gaussian 프로파일 블롭을 그린 8-bit 프레임
+static cv::Mat makeFrame(const SceneSpec& s, std::mt19937& rng)
+{
+    cv::Mat frame(s.height, s.width, CV_8UC1);
+    cv::randn(frame, cv::Scalar(10), cv::Scalar(s.noiseSigma));
+
+    std::uniform_real_distribution<float> sigmaDist(s.minSigma, s.maxSigma);
+    std::uniform_real_distribution<float> peakDist(220.f, 255.f);
+    for (int b = 0; b < s.blobs; b++)
+    {
+        float sigma = sigmaDist(rng);
+        int   r     = static_cast<int>(std::ceil(3.f * sigma));
+        std::uniform_real_distribution<float> xDist(static_cast<float>(r), static_cast<float>(s.width  - 1 - r));
+        std::uniform_real_distribution<float> yDist(static_cast<float>(r), static_cast<float>(s.height - 1 - r));
+        float cx   = xDist(rng);
+        float cy   = yDist(rng);
+        float peak = peakDist(rng);
+        float inv  = 1.f / (2.f * sigma * sigma);
+
+        for (int y = static_cast<int>(cy) - r; y <= static_cast<int>(cy) + r; y++)
+        {
+            uchar* row = frame.ptr<uchar>(y);
+            for (int x = static_cast<int>(cx) - r; x <= static_cast<int>(cx) + r; x++)
+            {
+                float d2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+                float v  = row[x] + peak * std::exp(-d2 * inv);
+                row[x]   = static_cast<uchar>(std::min(255.f, v));
+            }
+        }
+    }
+
+    std::uniform_int_distribution<int> px(0, s.width - 1), py(0, s.height - 1);
+    for (int i = 0; i < s.hotPixels; i++)
+        frame.at<uchar>(py(rng), px(rng)) = 255;
+    return frame;
+}
+
+// 프레임 안쪽 10% 여백의 4점 → 타깃 해상도 (onMouse 와 같은 computeHomography)
+static HomographyState makeHomography(int width, int height, const AppSettings& settings)
+{
+    HomographyState hom;
+    float mx = width * 0.1f, my = height * 0.1f;
+    hom.selectedPoints = {
+        { mx, my }, { width - mx, my + 8.f }, { width - mx - 8.f, height - my }, { mx + 8.f, height - my }
+    };
+    computeHomography(hom, settings.targetWidth, settings.targetHeight, settings.lens);
+    return hom;
+}
+
+// ========== 측정 ==========
+struct StageResult
+{
+    std::vector<long> ns;           // 샘플별 호출당 소요 시간
+    long              calls      = 0;   // 측정한 총 호출 수 (샘플 수 × reps)
+    long              heapAllocs = 0;   // 측정 구간 operator new 총합
+    long              bufAllocs  = 0;   // FrameProcessor::lastFrameAllocations() 합
+};
+
+static long percentile(std::vector<long>& v, double p)
+{
+    if (v.empty()) return 0;
+    size_t k = static_cast<size_t>(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+static void printStage(const char* name, StageResult& r, double pixels)
+{
+    size_t frames = r.ns.size();
+    if (frames == 0) return;
+    double sum = 0.0;
+    for (long n : r.ns) sum += static_cast<double>(n);
+    double mean = sum / frames;
+    long   p50  = percentile(r.ns, 0.50);
+    long   p99  = percentile(r.ns, 0.99);
+    double fps  = mean > 0.0 ? 1e9 / mean : 0.0;
+
+    printf("  %-8s frames=%-6zu p50=%9ld ns  p99=%9ld ns  mean=%11.0f ns  %9.0f f/s",
+           name, frames, p50, p99, mean, fps);
+    if (pixels > 0.0) printf("  %7.1f MPix/s", fps * pixels / 1e6);
+    else              printf("  %13s", "");
+    double calls = static_cast<double>(std::max(r.calls, 1L));
+    printf("  allocs/frame=%.2f  buf/frame=%.2f  (allocs=%ld over %ld calls)\n",
+           static_cast<double>(r.heapAllocs) / calls,
+           static_cast<double>(r.bufAllocs)  / calls,
+           r.heapAllocs, r.calls);
+}
+
+struct BenchOptions
+{
+    double      seconds     = 0.5;  // 단계별 측정 시간
+    bool        quick       = false;
+    int         threads     = 1;    // OpenCV 내부 스레드 (CI 재현성을 위해 기본 1)
+    long        maxDetectUs = 0;    // detect p50 한도 (0 = 검사 안 함)
+    AppSettings settings;
+};
+
+// fn(i) 를 seconds 동안 반복. 한 샘플 = reps 회 호출의 평균 (패킷 직렬화처럼 짧은 연산은 타이머 오차를 줄이려고 묶어 잼).
+// fn 반환값 = 그 호출의 FrameProcessor 버퍼 재할당 수.
+template <typename Fn>
+static void measure(StageResult& r, double seconds, int reps, Fn&& fn)
+{
+    auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                  std::chrono::duration<double>(seconds));
+    int i = 0;
+    do
+    {
+        long a0 = g_allocations.load(std::memory_order_relaxed);
+        auto t0 = Clock::now();
+        for (int k = 0; k < reps; k++) r.bufAllocs += fn(i++);
+        auto t1 = Clock::now();
+        r.heapAllocs += g_allocations.load(std::memory_order_relaxed) - a0;
+        r.calls      += reps;
+        r.ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / reps);
+    } while (Clock::now() < end);
+}
+
+// 한 장면의 모든 단계 측정. 반환: CI 실패 조건에 걸리면 false
+static bool runScene(const SceneSpec& spec, const BenchOptions& opt)
+{
+    std::mt19937 rng(static_cast<unsigned>(spec.width * 131 + spec.blobs * 7 +
+                                           static_cast<int>(spec.maxSigma * 10)));
+    std::vector<cv::Mat> frames;
+    for (int i = 0; i < FRAME_POOL; i++) frames.push_back(makeFrame(spec, rng));
+
+    const AppSettings& settings = opt.settings;
+    HomographyState    hom      = makeHomography(spec.width, spec.height, settings);
+    FrameProcessor     proc;
+    const int w = spec.width, h = spec.height;
+    auto frameAt = [&](int i) { return frames[i % FRAME_POOL].data; };
+
+    // warm-up: 풀 전체를 두 번 돌려 버퍼·벡터 capacity 를 steady-state 로
+    for (int i = 0; i < 2 * FRAME_POOL; i++) proc.process(frameAt(i), w, h, hom, settings);
+
+    const size_t reserve = static_cast<size_t>(opt.seconds * 100000) + 16;
+    StageResult detect, render, process, text, binary;
+    for (StageResult* r : { &detect, &render, &process, &text, &binary }) r->ns.reserve(reserve);
+
+    int detected = 0;
+    measure(detect, opt.seconds, 1, [&](int i)
+    {
+        detected = static_cast<int>(proc.detect(frameAt(i), w, h, hom, settings).detectedCenters.size());
+        return proc.lastFrameAllocations();
+    });
+
+    // render 는 같은 프레임의 detect() 직후에만 의미 있으므로 detect 는 측정 밖에서 호출
+    {
+        auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(opt.seconds));
+        int i = 0;
+        do
+        {
+            proc.detect(frameAt(i), w, h, hom, settings);
+            long a0 = g_allocations.load(std::memory_order_relaxed);
+            auto t0 = Clock::now();
+            proc.render(frameAt(i), w, h, hom, settings);
+            auto t1 = Clock::now();
+            render.heapAllocs += g_allocations.load(std::memory_order_relaxed) - a0;
+            render.bufAllocs  += proc.lastFrameAllocations();
+            render.calls++;
+            render.ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            i++;
+        } while (Clock::now() < end);
+    }
+
+    measure(process, opt.seconds, 1, [&](int i)
+    {
+        proc.process(frameAt(i), w, h, hom, settings);
+        return proc.lastFrameAllocations();
+    });
+
+    // 패킷 직렬화: 마지막 프레임의 영역 내 좌표를 UDPSender 와 같은 고정 크기 배치로
+    constexpr int MAX_POINTS  = 64;
+    constexpr int PACKET_REPS = 64;
+    const FrameResult& res = proc.detect(frameAt(0), w, h, hom, settings);
+    int   count = std::min(static_cast<int>(res.inBoundCenters.size()), MAX_POINTS);
+    float    xy[2 * MAX_POINTS];
+    uint32_t areas[MAX_POINTS];
+    for (int i = 0; i < count; i++)
+    {
+        xy[2 * i]     = res.inBoundCenters[i].x;
+        xy[2 * i + 1] = res.inBoundCenters[i].y;
+        areas[i]      = static_cast<uint32_t>(res.inBoundAreas[i]);
+    }
+
+    std::string textPacket;
+    textPacket.reserve(32 * MAX_POINTS);
+    measure(text, opt.seconds / 4, PACKET_REPS, [&](int)
+    {
+        formatTextPacket(textPacket, xy, count, opt.settings.udpDecimals);
+        return 0;
+    });
+
+    uint8_t binaryPacket[PACKET_HEADER_SIZE + 12 * MAX_POINTS];
+    PacketHeader header;
+    header.count = static_cast<uint16_t>(count);
+    header.flags = PACKET_FLAG_AREA;
+    measure(binary, opt.seconds / 4, PACKET_REPS, [&](int i)
+    {
+        header.sequence = static_cast<uint32_t>(i);
+        encodeBinaryPacket(binaryPacket, sizeof(binaryPacket), header, xy, areas);
+        return 0;
+    });
+
+    printf("[%dx%d  blobs=%d  sigma=%.1f-%.1f  noise=%.0f  hot=%d]  detected=%d  in-bound=%d\n",
+           spec.width, spec.height, spec.blobs, spec.minSigma, spec.maxSigma,
+           spec.noiseSigma, spec.hotPixels, detected, count);
+    double pixels = static_cast<double>(w) * h;
+    printStage("detect",  detect,  pixels);
+    printStage("render",  render,  pixels);
+    printStage("process", process, pixels);
+    printStage("text",    text,    0.0);
+    printStage("binary",  binary,  0.0);
+
+    bool ok = true;
+    long steadyBuf = detect.bufAllocs + render.bufAllocs + process.bufAllocs;
+    if (steadyBuf != 0)
+    {
+        printf("  FAIL: %ld FrameProcessor buffer reallocation(s) after warm-up\n", steadyBuf);
+        ok = false;
+    }
+    long detectP50Us = percentile(detect.ns, 0.50) / 1000;
+    if (opt.maxDetectUs > 0 && detectP50Us > opt.maxDetectUs)
+    {
+        printf("  FAIL: detect p50 %ld us > limit %ld us\n", detectP50Us, opt.maxDetectUs);
+        ok = false;
+    }
+    printf("\n");
+    return ok;
+}
+
+int main(int argc, char* argv[])
+{
+    BenchOptions opt;
+    opt.settings.roiDetection = false;      // detect 는 전체 프레임 기준 (ROI 축소 효과 제외)
+    for (int i = 1; i < argc; i++)
+    {
+        if      (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)       opt.seconds     = atof(argv[++i]);
+        else if (strcmp(argv[i], "--quick") == 0)                          opt.quick       = true;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)       opt.threads     = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-detect-us") == 0 && i + 1 < argc) opt.maxDetectUs = atol(argv[++i]);
+        else if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc)
+        {
+            if (!parseBlobKernel(argv[++i], opt.settings.blobKernel))
+            {
+                fprintf(stderr, "Unknown kernel: %s\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (strcmp(argv[i], "--centroid") == 0 && i + 1 < argc)
+        {
+            if (!parseCentroidMode(argv[++i], opt.settings.centroidMode))
+            {
+                fprintf(stderr, "Unknown centroid mode: %s\n", argv[i]);
+                return 2;
+            }
+        }
+    }
+    if (opt.quick) opt.seconds = std::min(opt.seconds, 0.1);
+    opt.seconds = std::max(opt.seconds, 0.01);
+    cv::setNumThreads(opt.threads);
+
+    // 해상도 × 블롭 수 × 블롭 크기. --quick 은 Flex 13 해상도의 대표 장면만.
+    std::vector<SceneSpec> scenes;
+    struct Res { int w, h; };
+    const Res resolutions[]  = { { 1280, 1024 }, { 1920, 1080 }, { 2048, 2048 } };
+    const int blobCounts[]   = { 0, 8, 64 };
+    const float sigmas[][2]  = { { 1.0f, 2.5f }, { 1.0f, 8.0f } };     // 작은 블롭만 / 크기 혼합
+    for (const Res& r : resolutions)
+    {
+        for (int n : blobCounts)
+        {
+            for (int k = 0; k < 2; k++)
+            {
+                if (n == 0 && k > 0) continue;      // 블롭 없으면 크기 무관
+                scenes.push_back({ r.w, r.h, n, sigmas[k][0], sigmas[k][1], 4.f, n > 0 ? 4 : 0 });
+            }
+        }
+        if (opt.quick) break;
+    }
+
+    printf("Detection benchmark: %zu scene(s), %.2f s per stage, OpenCV threads=%d, "
+           "kernel=%s, centroid=%s\n\n",
+           scenes.size(), opt.seconds, opt.threads,
+           blobKernelName(opt.settings.blobKernel), centroidModeName(opt.settings.centroidMode));
+
+    // 융합 커널 검증: 측정과 무관하게 CPU 가 지원하는 구현은 모두 검사
+    bool ok = true;
+    for (BlobKernel k : { BlobKernel::Scalar, BlobKernel::SSE2, BlobKernel::AVX2 })
+    {
+        if (resolveBlobKernel(k) != k)
+        {
+            printf("Kernel %-6s  skipped (not supported by this CPU)\n", blobKernelName(k));
+            continue;
+        }
+        bool verified = verifyBlobKernel(k);
+        printf("Kernel %-6s  %s\n", blobKernelName(k), verified ? "bit-exact vs OpenCV" : "FAIL: mismatch vs OpenCV");
+        ok = verified && ok;
+    }
+    printf("\n");
+
+    for (const SceneSpec& s : scenes) ok = runScene(s, opt) && ok;
+
+    printf(ok ? "OK\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
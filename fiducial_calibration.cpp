@@ -0,0 +1,198 @@
+#include "fiducial_calibration.h"
+
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+// 노드 대응 허용 거리 (노드 간격 대비). 절반 미만이라 이웃 노드와 겹치지 않음.
+static constexpr float MATCH_RADIUS = 0.35f;
+
+std::vector<cv::Point2f> FiducialParams::targetPoints(int targetWidth, int targetHeight) const
+{
+    int   c  = std::max(2, cols);
+    int   r  = std::max(2, rows);
+    float w  = static_cast<float>(targetWidth  - 1) - 2.f * marginPx;
+    float h  = static_cast<float>(targetHeight - 1) - 2.f * marginPx;
+    std::vector<cv::Point2f> pts;
+    pts.reserve(static_cast<size_t>(c) * r);
+    for (int y = 0; y < r; y++)
+        for (int x = 0; x < c; x++)
+            pts.emplace_back(marginPx + w * x / (c - 1), marginPx + h * y / (r - 1));
+    return pts;
+}
+
+FiducialCalibrator::FiducialCalibrator(const FiducialParams& params, int targetWidth,
+                                       int targetHeight, const LensModel& lens)
+    : params_(params), targetWidth_(targetWidth), targetHeight_(targetHeight), lens_(lens)
+{
+    params_.cols = std::max(2, params_.cols);
+    params_.rows = std::max(2, params_.rows);
+    grid_        = params_.targetPoints(targetWidth, targetHeight);
+    spacingX_    = (static_cast<float>(targetWidth  - 1) - 2.f * params_.marginPx) / (params_.cols - 1);
+    spacingY_    = (static_cast<float>(targetHeight - 1) - 2.f * params_.marginPx) / (params_.rows - 1);
+}
+
+void FiducialCalibrator::reset()
+{
+    src_.clear();
+    dst_.clear();
+    matchedFrames_ = 0;
+    lastMatched_   = 0;
+}
+
+// h 로 투영한 점을 가장 가까운 격자 노드에 대응. 노드마다 가장 가까운 점 하나만 남김.
+// nodeOf[i] = 점 i 의 노드 인덱스 (-1 = 대응 없음). 반환값 = 대응된 노드 수.
+int FiducialCalibrator::matchToGrid(const std::vector<cv::Point2f>& points, const cv::Mat& h,
+                                    std::vector<int>& nodeOf) const
+{
+    std::vector<cv::Point2f> projected;
+    cv::perspectiveTransform(points, projected, h);
+
+    float radius = MATCH_RADIUS * std::min(spacingX_, spacingY_);
+    std::vector<int>   bestPoint(grid_.size(), -1);
+    std::vector<float> bestDist(grid_.size(), radius);
+    for (size_t i = 0; i < projected.size(); i++)
+    {
+        int c = static_cast<int>(std::lround((projected[i].x - params_.marginPx) / spacingX_));
+        int r = static_cast<int>(std::lround((projected[i].y - params_.marginPx) / spacingY_));
+        if (c < 0 || c >= params_.cols || r < 0 || r >= params_.rows) continue;
+        int   node = r * params_.cols + c;
+        float d    = static_cast<float>(cv::norm(projected[i] - grid_[node]));
+        if (d < bestDist[node])
+        {
+            bestDist[node]  = d;
+            bestPoint[node] = static_cast<int>(i);
+        }
+    }
+
+    nodeOf.assign(points.size(), -1);
+    int matched = 0;
+    for (size_t n = 0; n < grid_.size(); n++)
+    {
+        if (bestPoint[n] < 0) continue;
+        nodeOf[bestPoint[n]] = static_cast<int>(n);
+        ++matched;
+    }
+    return matched;
+}
+
+bool FiducialCalibrator::addFrame(const std::vector<cv::Point2f>& detected)
+{
+    lastMatched_ = 0;
+    if (detected.size() < 4) return false;
+
+    std::vector<cv::Point2f> points;
+    undistortPixels(lens_, detected, points);
+
+    // 네 극단점 → 격자 바깥 모서리 (왼쪽 위, 오른쪽 위, 오른쪽 아래, 왼쪽 아래)
+    size_t tl = 0, tr = 0, br = 0, bl = 0;
+    for (size_t i = 1; i < points.size(); i++)
+    {
+        const cv::Point2f& p = points[i];
+        if (p.x + p.y < points[tl].x + points[tl].y) tl = i;
+        if (p.x + p.y > points[br].x + points[br].y) br = i;
+        if (p.x - p.y > points[tr].x - points[tr].y) tr = i;
+        if (p.y - p.x > points[bl].y - points[bl].x) bl = i;
+    }
+    if (tl == tr || tl == br || tl == bl || tr == br || tr == bl || br == bl) return false;
+
+    int cols = params_.cols, rows = params_.rows;
+    std::vector<cv::Point2f> srcCorners = { points[tl], points[tr], points[br], points[bl] };
+    std::vector<cv::Point2f> dstCorners = {
+        grid_[0], grid_[cols - 1], grid_[rows * cols - 1], grid_[(rows - 1) * cols]
+    };
+    cv::Mat h = cv::getPerspectiveTransform(srcCorners, dstCorners);
+
+    // 초기 대응 → 최소제곱 재추정 → 재대응 (원근이 강해도 안쪽 노드까지 정확히 대응)
+    std::vector<int> nodeOf;
+    int minMatched = std::max(4, static_cast<int>(grid_.size() + 1) / 2);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if (matchToGrid(points, h, nodeOf) < minMatched) return false;
+        std::vector<cv::Point2f> s, d;
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            if (nodeOf[i] < 0) continue;
+            s.push_back(points[i]);
+            d.push_back(grid_[nodeOf[i]]);
+        }
+        cv::Mat refined = cv::findHomography(s, d, 0);
+        if (refined.empty()) return false;
+        h = refined;
+    }
+
+    lastMatched_ = matchToGrid(points, h, nodeOf);
+    if (lastMatched_ < minMatched) return false;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        if (nodeOf[i] < 0) continue;
+        src_.push_back(points[i]);
+        dst_.push_back(grid_[nodeOf[i]]);
+    }
+    ++matchedFrames_;
+    return true;
+}
+
+FiducialFitResult FiducialCalibrator::solve() const
+{
+    FiducialFitResult fit;
+    fit.frames          = matchedFrames_;
+    fit.correspondences = static_cast<int>(src_.size());
+    if (src_.size() < 8)
+    {
+        fit.error = "not enough fiducial correspondences (need >= 8, got " +
+                    std::to_string(src_.size()) + ")";
+        return fit;
+    }
+
+    // RANSAC 으로 오대응 제거 → 인라이어 전체로 최소제곱 재추정
+    std::vector<uchar> mask;
+    cv::Mat h = cv::findHomography(src_, dst_, cv::RANSAC, params_.ransacPx, mask);
+    if (h.empty())
+    {
+        fit.error = "homography estimation failed";
+        return fit;
+    }
+    std::vector<cv::Point2f> s, d;
+    for (size_t i = 0; i < mask.size(); i++)
+    {
+        if (!mask[i]) continue;
+        s.push_back(src_[i]);
+        d.push_back(dst_[i]);
+    }
+    if (s.size() < 8)
+    {
+        fit.error = "too few RANSAC inliers (" + std::to_string(s.size()) + ")";
+        return fit;
+    }
+    h = cv::findHomography(s, d, 0);
+
+    std::vector<cv::Point2f> projected;
+    cv::perspectiveTransform(s, projected, h);
+    double sumSq = 0.0;
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        double e = cv::norm(projected[i] - d[i]);
+        sumSq     += e * e;
+        fit.maxPx  = std::max(fit.maxPx, e);
+    }
+    fit.inliers = static_cast<int>(s.size());
+    fit.rmsPx   = std::sqrt(sumSq / s.size());
+    fit.matrix  = h;
+
+    // 타깃 사각형 모서리 → 카메라 px (왜곡 다시 적용). 이 4점으로 computeHomography 를 하면 같은 행렬.
+    float tw = static_cast<float>(targetWidth_  - 1);
+    float th = static_cast<float>(targetHeight_ - 1);
+    std::vector<cv::Point2f> targetCorners = { {0.f, 0.f}, {tw, 0.f}, {tw, th}, {0.f, th} };
+    std::vector<cv::Point2f> cameraCorners;
+    cv::perspectiveTransform(targetCorners, cameraCorners, h.inv());
+    for (const cv::Point2f& c : cameraCorners)
+    {
+        cv::Point2d raw = distortPixel(lens_, cv::Point2d(c.x, c.y));
+        fit.corners.emplace_back(static_cast<float>(raw.x), static_cast<float>(raw.y));
+    }
+    fit.ok = true;
+    return fit;
+}
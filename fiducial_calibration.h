@@ -0,0 +1,77 @@
+#pragma once
+
+#include "lens_model.h"
+
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+
+// ========== 기준점(fiducial) 격자 ==========
+// 타깃 평면에 cols × rows 개의 IR 기준점을 등간격으로 배치 (투사 또는 부착).
+// 바깥쪽 기준점은 타깃 사각형 가장자리에서 marginPx 안쪽. setting.cfg: fiducial_*
+struct FiducialParams
+{
+    int   cols     = 5;
+    int   rows     = 4;
+    float marginPx = 0.f;       // 타깃 좌표 px
+    float ransacPx = 3.f;       // RANSAC 인라이어 한계 (타깃 좌표 px)
+
+    // 기준점의 타깃 좌표 (행 우선, 왼쪽 위부터)
+    std::vector<cv::Point2f> targetPoints(int targetWidth, int targetHeight) const;
+};
+
+// ========== 자동 호모그래피 추정 결과 ==========
+struct FiducialFitResult
+{
+    bool        ok = false;
+    std::string error;
+
+    cv::Mat                  matrix;    // 왜곡 제거 카메라 px → 타깃 (HomographyState::matrix 와 같은 정의)
+    std::vector<cv::Point2f> corners;   // 타깃 사각형 4 모서리의 원본 카메라 px (왼쪽 위부터 시계 방향)
+                                        // → HomographyState::selectedPoints / setting.cfg corner*
+
+    int    frames          = 0;         // 격자와 대응된 프레임 수
+    int    correspondences = 0;         // 누적 대응점 수
+    int    inliers         = 0;
+    double rmsPx           = 0.0;       // 인라이어 재투영 오차 (타깃 px)
+    double maxPx           = 0.0;
+};
+
+// ========== 기준점 격자 자동 캘리브레이션 ==========
+// FrameProcessor::detect() 의 detectedCenters (원본 카메라 px) 를 프레임마다 넣으면
+//   1) 렌즈 보정 → 네 극단점(x±y)을 격자 바깥 모서리로 가정해 초기 호모그래피
+//   2) 격자 노드에 최근접 대응 (노드 간격의 35% 이내, 노드당 하나) → 최소제곱 재추정 → 재대응
+// 으로 대응점을 누적하고, solve() 가 전체 대응점으로 RANSAC + 인라이어 최소제곱 호모그래피를 구한다.
+// 카메라가 타깃과 대략 같은 방향(90° 이상 회전 없음)이고 격자 밖 IR 점이 없다고 가정.
+class FiducialCalibrator
+{
+public:
+    FiducialCalibrator(const FiducialParams& params, int targetWidth, int targetHeight,
+                       const LensModel& lens);
+
+    // 격자의 절반 이상이 대응되면 대응점을 누적하고 true
+    bool addFrame(const std::vector<cv::Point2f>& detected);
+
+    int  matchedFrames() const { return matchedFrames_; }
+    int  lastMatched()   const { return lastMatched_; }
+    void reset();
+
+    FiducialFitResult solve() const;
+
+private:
+    int  matchToGrid(const std::vector<cv::Point2f>& points, const cv::Mat& h,
+                     std::vector<int>& nodeOf) const;
+
+    FiducialParams           params_;
+    int                      targetWidth_;
+    int                      targetHeight_;
+    LensModel                lens_;
+    std::vector<cv::Point2f> grid_;         // 기준점 타깃 좌표
+    float                    spacingX_ = 1.f;
+    float                    spacingY_ = 1.f;
+
+    std::vector<cv::Point2f> src_;          // 누적: 왜곡 제거 카메라 px
+    std::vector<cv::Point2f> dst_;          // 누적: 기준점 타깃 좌표
+    int                      matchedFrames_ = 0;
+    int                      lastMatched_   = 0;
+};
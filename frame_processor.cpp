@@ -1,47 +1,20 @@
 #include "frame_processor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
 #include <string>
 
+// ROI 여백: dilate 반경(3×3 커널 3회 = 3px). ROI 밖 밝은 점이 영역 안으로 번지는 것까지 포함.
+static constexpr int ROI_MARGIN = 3;
+
+// 렌즈 보정 시 타깃 사각형 한 변을 나누는 구간 수 (휜 변을 따라가는 외곽선 점 밀도)
+static constexpr int OUTLINE_SEGMENTS = 16;
+
 // ─────────────────────────────────────────────────────────
 //  내부 헬퍼 함수 (파일 static)
 // ─────────────────────────────────────────────────────────
 
-// Dilate → Threshold → Contour 검출 → 중심점 계산
-// binaryDisplayOut: 시각화용 컬러 바이너리 이미지 (BGR)
-static std::vector<cv::Point2f> detectCenters(
-    const cv::Mat& gray,
-    cv::Mat&       binaryDisplayOut)
-{
-    cv::Mat dilated;
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
-    cv::dilate(gray, dilated, kernel, cv::Point(-1, -1), 3);
-
-    cv::Mat binary;
-    cv::threshold(dilated, binary, 200, 255, cv::THRESH_BINARY);
-
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours(binary.clone(), contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-
-    cv::cvtColor(binary, binaryDisplayOut, cv::COLOR_GRAY2BGR);
-
-    std::vector<cv::Point2f> centers;
-    for (const auto& contour : contours)
-    {
-        cv::Moments m = cv::moments(contour);
-        if (m.m00 > 0)
-        {
-            int cx = static_cast<int>(m.m10 / m.m00);
-            int cy = static_cast<int>(m.m01 / m.m00);
-            centers.emplace_back(static_cast<float>(cx), static_cast<float>(cy));
-
-            cv::circle(binaryDisplayOut, cv::Point(cx, cy), 5, cv::Scalar(0, 0, 255), -1);
-            std::string txt = "(" + std::to_string(cx) + "," + std::to_string(cy) + ")";
-            cv::putText(binaryDisplayOut, txt, cv::Point(cx + 10, cy - 5),
-                        cv::FONT_HERSHEY_SIMPLEX, 0.4, cv::Scalar(0, 255, 0), 1);
-        }
-    }
-    return centers;
-}
-
 // 선택된 4점을 왼쪽 패널에 표시
 static void drawSelectedPoints(cv::Mat& img, const std::vector<cv::Point2f>& pts)
 {
@@ -62,87 +35,528 @@ static void drawSelectedPoints(cv::Mat& img, const std::vector<cv::Point2f>& pts
     }
 }
 
-// 호모그래피 적용 패널 생성 + 경계 내 좌표 수집
-static cv::Mat buildWarpedPanel(
-    const cv::Mat&                  gray,
-    const std::vector<cv::Point2f>& detectedCenters,
-    const HomographyState&          hom,
-    const AppSettings&              settings,
-    std::vector<cv::Point2f>&       inBoundOut)
+// 좌표 점 + "(x,y)" 라벨 표시 (문자열은 SSO 범위라 힙 할당 없음)
+// pos 는 그릴 위치, (labelX, labelY) 는 라벨에 적을 좌표 (warp 패널에선 타깃 좌표)
+static void drawLabeledPoint(cv::Mat& img, cv::Point pos, int labelX, int labelY)
+{
+    char txt[32];
+    snprintf(txt, sizeof(txt), "(%d,%d)", labelX, labelY);
+    cv::circle(img, pos, 5, cv::Scalar(0, 0, 255), -1);
+    cv::putText(img, txt, cv::Point(pos.x + 10, pos.y - 5),
+                cv::FONT_HERSHEY_SIMPLEX, 0.4, cv::Scalar(0, 255, 0), 1);
+}
+
+static void drawLabeledPoint(cv::Mat& img, int x, int y)
+{
+    drawLabeledPoint(img, cv::Point(x, y), x, y);
+}
+
+// ─────────────────────────────────────────────────────────
+//  FrameProcessor
+// ─────────────────────────────────────────────────────────
+
+FrameProcessor::FrameProcessor()
+{
+    kernel_ = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+}
+
+void FrameProcessor::trackMat(const cv::Mat& m, const uchar* before)
+{
+    if (m.data != before) ++frameAllocs_;
+}
+
+// 설정된 Dilate+Threshold 구현 선택. CPU 미지원 구현은 대체하고,
+// 선택된 융합 커널은 OpenCV 결과와 비트 단위로 일치하는지 한 번 검증한다.
+void FrameProcessor::selectKernel(BlobKernel requested)
+{
+    requestedKernel_ = requested;
+    kernelSelected_  = true;
+
+    BlobKernel resolved = resolveBlobKernel(requested);
+    if (!verifyBlobKernel(resolved))
+    {
+        std::cerr << "[FrameProcessor] Blob kernel '" << blobKernelName(resolved)
+                  << "' failed verification. Falling back to OpenCV." << std::endl;
+        resolved = BlobKernel::OpenCV;
+    }
+    activeKernel_ = resolved;
+    std::cout << "[FrameProcessor] Blob kernel: " << blobKernelName(activeKernel_)
+              << " (requested " << blobKernelName(requested) << ")" << std::endl;
+}
+
+// 원본 카메라 픽셀에서의 타깃 영역 외곽선. 렌즈 보정이 켜져 있으면 코너 사이 변이 직선이 아니므로
+// (배럴 왜곡이면 바깥으로 휨) 타깃 사각형 둘레를 샘플링해 역호모그래피 → distortPixel 로 옮긴다.
+const std::vector<cv::Point2f>& FrameProcessor::detectionOutline(const HomographyState& hom,
+                                                                 const AppSettings& settings)
 {
-    cv::Mat warped;
-    cv::warpPerspective(gray, warped, hom.matrix,
-                        cv::Size(settings.targetWidth, settings.targetHeight));
-    cv::Mat warpedColor;
-    cv::cvtColor(warped, warpedColor, cv::COLOR_GRAY2BGR);
+    cv::Matx33d h = hom.matrix;
+    if (outlineValid_ && outlineCorners_ == hom.selectedPoints && outlineHom_ == h &&
+        outlineLens_ == settings.lens)
+        return outline_;
+
+    outlineValid_   = true;
+    outlineCorners_ = hom.selectedPoints;
+    outlineHom_     = h;
+    outlineLens_    = settings.lens;
 
-    if (!detectedCenters.empty())
+    outline_.clear();
+    if (!settings.lens.active())
     {
-        std::vector<cv::Point2f> transformed;
-        cv::perspectiveTransform(detectedCenters, transformed, hom.matrix);
+        outline_ = hom.selectedPoints;
+        return outline_;
+    }
 
-        for (size_t i = 0; i < transformed.size(); i++)
+    // computeHomography 의 타깃 코너와 같은 순서 (0,0) → (tw,0) → (tw,th) → (0,th)
+    cv::Matx33d inv = h.inv();
+    double tw = settings.targetWidth - 1, th = settings.targetHeight - 1;
+    const cv::Point2d corners[4] = { { 0.0, 0.0 }, { tw, 0.0 }, { tw, th }, { 0.0, th } };
+    for (int e = 0; e < 4; e++)
+    {
+        cv::Point2d a = corners[e], b = corners[(e + 1) % 4];
+        for (int i = 0; i < OUTLINE_SEGMENTS; i++)
         {
-            if (transformed[i].x >= 0 && transformed[i].x < settings.targetWidth &&
-                transformed[i].y >= 0 && transformed[i].y < settings.targetHeight)
+            double      s = static_cast<double>(i) / OUTLINE_SEGMENTS;
+            cv::Point2d t = a + (b - a) * s;
+            double      w = inv(2, 0) * t.x + inv(2, 1) * t.y + inv(2, 2);
+            if (std::abs(w) < 1e-12) continue;
+            cv::Point2d src((inv(0, 0) * t.x + inv(0, 1) * t.y + inv(0, 2)) / w,
+                            (inv(1, 0) * t.x + inv(1, 1) * t.y + inv(1, 2)) / w);
+            src = distortPixel(settings.lens, src);
+            outline_.emplace_back(static_cast<float>(src.x), static_cast<float>(src.y));
+        }
+    }
+    if (outline_.size() < 3) outline_ = hom.selectedPoints;
+    return outline_;
+}
+
+// 검출 영역: 호모그래피 설정 후엔 타깃 외곽선 바운딩 박스 + 여백, 그 전엔 전체 프레임
+cv::Rect FrameProcessor::computeRoi(int width, int height, const HomographyState& hom,
+                                    const AppSettings& settings)
+{
+    cv::Rect full(0, 0, width, height);
+    if (!settings.roiDetection || !hom.ready ||
+        static_cast<int>(hom.selectedPoints.size()) != HomographyState::REQUIRED_POINTS)
+        return full;
+
+    const std::vector<cv::Point2f>& outline = detectionOutline(hom, settings);
+    float minX = outline[0].x, maxX = minX;
+    float minY = outline[0].y, maxY = minY;
+    for (const auto& p : outline)
+    {
+        minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+        minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+    }
+    int x0 = std::max(0,      static_cast<int>(std::floor(minX)) - ROI_MARGIN);
+    int y0 = std::max(0,      static_cast<int>(std::floor(minY)) - ROI_MARGIN);
+    int x1 = std::min(width,  static_cast<int>(std::ceil(maxX))  + ROI_MARGIN + 1);
+    int y1 = std::min(height, static_cast<int>(std::ceil(maxY))  + ROI_MARGIN + 1);
+    if (x1 <= x0 || y1 <= y0) return full;
+    return cv::Rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+// ROI 좌표계의 타깃 외곽선 다각형 마스크 (computeRoi 가 갱신한 외곽선 사용).
+// 외곽선이나 ROI 가 바뀐 경우에만 다시 그린다. 렌즈 왜곡으로 변이 안쪽으로 휠 수도 있어 fillPoly.
+void FrameProcessor::updatePolygonMask(const cv::Rect& roi)
+{
+    if (!polyMask_.empty() && roi == polyMaskRoi_ && outline_ == polyMaskCorners_)
+        return;
+
+    polyMaskRoi_     = roi;
+    polyMaskCorners_ = outline_;
+
+    polyPoints_.clear();
+    for (const auto& p : outline_)
+        polyPoints_.emplace_back(cvRound(p.x) - roi.x, cvRound(p.y) - roi.y);
+
+    const uchar* before = polyMask_.data;
+    polyMask_.create(roi.height, roi.width, CV_8UC1);
+    trackMat(polyMask_, before);
+    polyMask_.setTo(cv::Scalar(0));
+    const cv::Point* pts   = polyPoints_.data();
+    int              count = static_cast<int>(polyPoints_.size());
+    cv::fillPoly(polyMask_, &pts, &count, 1, cv::Scalar(255));
+}
+
+// 블롭 바운딩 박스 안 전경 픽셀로 ln(w) = a + b·u + c·v + d·u² + e·v² 를 가중 최소제곱 피팅
+// (w = g - floor, 가중치 w² — 어두운 가장자리의 log 잡음 억제). 축 정렬 2D Gaussian 의 정점이 중심.
+// b 와 gray/mask 는 같은 (ROI) 좌표계. 피팅 실패/비정상 결과면 false.
+static bool fitGaussianCenter(const cv::Mat& gray, const cv::Mat& mask, const Blob& b,
+                              int floor, float& cxOut, float& cyOut)
+{
+    const double u0 = b.cx, v0 = b.cy;      // 수치 안정용 기준점
+    cv::Matx<double, 5, 5> A = cv::Matx<double, 5, 5>::zeros();
+    cv::Vec<double, 5>     rhs;
+    int n = 0;
+
+    for (int y = b.y0; y <= b.y1; y++)
+    {
+        const uint8_t* g = gray.ptr<uint8_t>(y);
+        const uint8_t* m = mask.ptr<uint8_t>(y);
+        for (int x = b.x0; x <= b.x1; x++)
+        {
+            int w = m[x] ? static_cast<int>(g[x]) - floor : 0;
+            if (w <= 1) continue;
+
+            double u = x - u0, v = y - v0;
+            double f[5] = { 1.0, u, v, u * u, v * v };
+            double ww = static_cast<double>(w) * w;
+            double z  = std::log(static_cast<double>(w));
+            for (int i = 0; i < 5; i++)
             {
-                inBoundOut.push_back(transformed[i]);
-
-                cv::circle(warpedColor, transformed[i], 5, cv::Scalar(0, 0, 255), -1);
-                int tx = static_cast<int>(transformed[i].x);
-                int ty = static_cast<int>(transformed[i].y);
-                std::string txt = "(" + std::to_string(tx) + "," + std::to_string(ty) + ")";
-                cv::putText(warpedColor, txt, cv::Point(tx + 10, ty - 5),
-                            cv::FONT_HERSHEY_SIMPLEX, 0.4, cv::Scalar(0, 255, 0), 1);
+                rhs[i] += ww * f[i] * z;
+                for (int j = 0; j < 5; j++) A(i, j) += ww * f[i] * f[j];
             }
+            ++n;
         }
     }
-    return warpedColor;
+    if (n < 5) return false;
+
+    cv::Vec<double, 5> sol = A.solve(rhs, cv::DECOMP_CHOLESKY);
+    double d = sol[3], e = sol[4];
+    if (!(d < 0.0) || !(e < 0.0)) return false;    // 위로 볼록해야 정점이 최대
+
+    double cx = u0 - sol[1] / (2.0 * d);
+    double cy = v0 - sol[2] / (2.0 * e);
+    if (cx < b.x0 || cx > b.x1 || cy < b.y0 || cy > b.y1) return false;
+
+    cxOut = static_cast<float>(cx);
+    cyOut = static_cast<float>(cy);
+    return true;
+}
+
+// Dilate → Threshold → 연결 요소 라벨링 → sub-pixel 중심점 계산
+// gray 는 검출 영역(ROI) 헤더일 수 있으며, 결과 좌표는 roi 만큼 이동해 프레임 좌표로 돌려준다.
+void FrameProcessor::detectCenters(const cv::Mat& gray, const AppSettings& settings)
+{
+    if (!kernelSelected_ || settings.blobKernel != requestedKernel_)
+        selectKernel(settings.blobKernel);
+
+    // 이진화 임계값: dilate 결과가 이 값보다 크면 객체 (auto_threshold 면 처리 스레드가 프레임마다 갱신)
+    int threshold = std::max(1, std::min(254, settings.levels.threshold));
+
+    const uchar* binaryBefore = binary_.data;
+    if (activeKernel_ == BlobKernel::OpenCV)
+    {
+        const uchar* dilatedBefore = dilated_.data;
+        cv::dilate(gray, dilated_, kernel_, cv::Point(-1, -1), 3);
+        trackMat(dilated_, dilatedBefore);
+
+        cv::threshold(dilated_, binary_, threshold, 255, cv::THRESH_BINARY);
+    }
+    else
+    {
+        // 3×3 dilate 3회 + threshold 를 한 번의 스트리밍 패스로
+        binary_.create(gray.rows, gray.cols, CV_8UC1);
+        size_t scratchCap = kernelScratch_.capacity();
+        dilateThreshold7x7(gray.data, gray.step, binary_.data, binary_.step,
+                           gray.cols, gray.rows, static_cast<uint8_t>(threshold),
+                           activeKernel_, kernelScratch_);
+        trackVec(kernelScratch_, scratchCap);
+    }
+    trackMat(binary_, binaryBefore);
+
+    const cv::Rect& roi = result_.detectionRoi;
+    if (settings.roiPolygonMask && !polyMask_.empty() && roi == polyMaskRoi_)
+        cv::bitwise_and(binary_, polyMask_, binary_);
+
+    // Run-length 연결 요소 → 블롭 면적/무게중심 (윤곽선 점 리스트 없이 한 번의 패스)
+    size_t runCap   = labeler_.runCapacity();
+    size_t blobsCap = result_.blobs.capacity();
+    bool weighted = settings.centroidMode != CentroidMode::Binary;
+    labeler_.label(binary_.data, binary_.step, binary_.cols, binary_.rows,
+                   weighted ? gray.data : nullptr, gray.step,
+                   static_cast<uint8_t>(settings.centroidWeightFloor), result_.blobs);
+    if (labeler_.runCapacity() != runCap) ++frameAllocs_;
+    trackVec(result_.blobs, blobsCap);
+
+    // 원본 밝기 기반 중심점 보정 (ROI 좌표계에서 수행)
+    if (weighted)
+    {
+        for (Blob& b : result_.blobs)
+        {
+            if (b.sumW > 0)
+            {
+                b.cx = static_cast<float>(static_cast<double>(b.sumWX) / b.sumW);
+                b.cy = static_cast<float>(static_cast<double>(b.sumWY) / b.sumW);
+            }
+            if (settings.centroidMode == CentroidMode::Gaussian && b.area <= settings.gaussianMaxArea)
+                fitGaussianCenter(gray, binary_, b, settings.centroidWeightFloor, b.cx, b.cy);
+        }
+    }
+
+    std::vector<cv::Point2f>& centers = result_.detectedCenters;
+    size_t centersCap = centers.capacity();
+    centers.clear();
+    for (Blob& b : result_.blobs)
+    {
+        b.cx += roi.x;  b.cy += roi.y;
+        b.x0 += roi.x;  b.x1 += roi.x;
+        b.y0 += roi.y;  b.y1 += roi.y;
+        centers.emplace_back(b.cx, b.cy);
+    }
+    trackVec(centers, centersCap);
+}
+
+// 호모그래피 전 오른쪽 패널: 컬러 바이너리 + 검출 좌표
+void FrameProcessor::buildBinaryPanel()
+{
+    const uchar* before = result_.rightPanel.data;
+    cv::cvtColor(binary_, result_.rightPanel, cv::COLOR_GRAY2BGR);
+    trackMat(result_.rightPanel, before);
+
+    for (const auto& c : result_.detectedCenters)
+        drawLabeledPoint(result_.rightPanel, static_cast<int>(c.x), static_cast<int>(c.y));
+}
+
+// 검출 중심점만 (렌즈 왜곡 제거 후) 타깃 평면으로 변환 → 경계 내 좌표 수집 (영상 warp 없음)
+void FrameProcessor::transformCenters(const HomographyState& hom, const AppSettings& settings)
+{
+    std::vector<cv::Point2f>& inBound = result_.inBoundCenters;
+    std::vector<int>&         areas   = result_.inBoundAreas;
+    size_t inBoundCap = inBound.capacity();
+    size_t areasCap   = areas.capacity();
+    inBound.clear();
+    areas.clear();
+
+    if (hom.ready && !result_.detectedCenters.empty())
+    {
+        const std::vector<cv::Point2f>* src = &result_.detectedCenters;
+        if (settings.lens.active())
+        {
+            size_t undistortedCap = undistorted_.capacity();
+            undistortPixels(settings.lens, result_.detectedCenters, undistorted_);
+            trackVec(undistorted_, undistortedCap);
+            src = &undistorted_;
+        }
+
+        size_t transformedCap = transformed_.capacity();
+        cv::perspectiveTransform(*src, transformed_, hom.matrix);
+        trackVec(transformed_, transformedCap);
+
+        for (size_t i = 0; i < transformed_.size(); i++)
+        {
+            const cv::Point2f& p = transformed_[i];
+            if (p.x >= 0 && p.x < settings.targetWidth &&
+                p.y >= 0 && p.y < settings.targetHeight)
+            {
+                inBound.push_back(p);
+                areas.push_back(result_.blobs[i].area);
+            }
+        }
+    }
+    trackVec(inBound, inBoundCap);
+    trackVec(areas, areasCap);
+}
+
+// warp 미리보기용 remap 테이블 갱신. 패널 픽셀 (u, v) 를 타깃 좌표로 늘린 뒤
+// (cv::resize 와 같은 픽셀 중심 정렬) 역호모그래피 → 렌즈 왜곡 적용으로 원본 좌표를 구해 둔다.
+// 타깃 해상도 중간 영상 없이 패널 크기로 바로 그리므로 프레임당 비용은 패널 픽셀 수에만 비례.
+void FrameProcessor::updateWarpMaps(const HomographyState& hom, const AppSettings& settings,
+                                    int panelWidth, int panelHeight)
+{
+    cv::Matx33d h = hom.matrix;
+    cv::Size    target(settings.targetWidth, settings.targetHeight);
+    if (!warpMapXY_.empty() && warpMapXY_.cols == panelWidth && warpMapXY_.rows == panelHeight &&
+        warpMapTarget_ == target && warpMapHom_ == h && warpMapLens_ == settings.lens)
+        return;
+
+    warpMapHom_    = h;
+    warpMapTarget_ = target;
+    warpMapLens_   = settings.lens;
+    bool lensActive = settings.lens.active();
+
+    cv::Matx33d inv = h.inv();
+    double sx = static_cast<double>(target.width)  / panelWidth;
+    double sy = static_cast<double>(target.height) / panelHeight;
+
+    const uchar* xfBefore = warpMapXf_.data;
+    const uchar* yfBefore = warpMapYf_.data;
+    warpMapXf_.create(panelHeight, panelWidth, CV_32FC1);
+    warpMapYf_.create(panelHeight, panelWidth, CV_32FC1);
+    trackMat(warpMapXf_, xfBefore);
+    trackMat(warpMapYf_, yfBefore);
+
+    for (int v = 0; v < panelHeight; v++)
+    {
+        float* mx = warpMapXf_.ptr<float>(v);
+        float* my = warpMapYf_.ptr<float>(v);
+        double ty = (v + 0.5) * sy - 0.5;
+        for (int u = 0; u < panelWidth; u++)
+        {
+            double tx = (u + 0.5) * sx - 0.5;
+            double w  = inv(2, 0) * tx + inv(2, 1) * ty + inv(2, 2);
+            if (std::abs(w) < 1e-12)
+            {
+                // 소실선 위: 영상 밖으로 보내 검은색으로 채움
+                mx[u] = -1.f;
+                my[u] = -1.f;
+                continue;
+            }
+            cv::Point2d src((inv(0, 0) * tx + inv(0, 1) * ty + inv(0, 2)) / w,
+                            (inv(1, 0) * tx + inv(1, 1) * ty + inv(1, 2)) / w);
+            if (lensActive) src = distortPixel(settings.lens, src);
+            mx[u] = static_cast<float>(src.x);
+            my[u] = static_cast<float>(src.y);
+        }
+    }
+
+    const uchar* xyBefore   = warpMapXY_.data;
+    const uchar* fracBefore = warpMapFrac_.data;
+    cv::convertMaps(warpMapXf_, warpMapYf_, warpMapXY_, warpMapFrac_, CV_16SC2);
+    trackMat(warpMapXY_, xyBefore);
+    trackMat(warpMapFrac_, fracBefore);
+}
+
+// 호모그래피 적용 패널 생성 (원본 프레임 크기) + 경계 내 좌표 표시
+void FrameProcessor::buildWarpedPanel(
+    const cv::Mat&         gray,
+    const HomographyState& hom,
+    const AppSettings&     settings)
+{
+    updateWarpMaps(hom, settings, gray.cols, gray.rows);
+
+    const uchar* warpedBefore = warped_.data;
+    cv::remap(gray, warped_, warpMapXY_, warpMapFrac_, cv::INTER_LINEAR,
+              cv::BORDER_CONSTANT, cv::Scalar(0));
+    trackMat(warped_, warpedBefore);
+
+    const uchar* rightBefore = result_.rightPanel.data;
+    cv::cvtColor(warped_, result_.rightPanel, cv::COLOR_GRAY2BGR);
+    trackMat(result_.rightPanel, rightBefore);
+
+    // 표시 위치만 패널 크기로 축소, 라벨은 타깃 좌표 그대로
+    float px = static_cast<float>(gray.cols) / settings.targetWidth;
+    float py = static_cast<float>(gray.rows) / settings.targetHeight;
+    for (const auto& p : result_.inBoundCenters)
+        drawLabeledPoint(result_.rightPanel,
+                         cv::Point(static_cast<int>(p.x * px), static_cast<int>(p.y * py)),
+                         static_cast<int>(p.x), static_cast<int>(p.y));
 }
 
 // ─────────────────────────────────────────────────────────
 //  Public API
 // ─────────────────────────────────────────────────────────
 
-FrameResult processFrame(
-    const unsigned char* rawData,
-    int                  width,
-    int                  height,
+void FrameProcessor::endFrame()
+{
+    lastFrameAllocs_ = frameAllocs_;
+    totalAllocs_    += frameAllocs_;
+}
+
+const FrameResult& FrameProcessor::detect(
+    const unsigned char*   rawData,
+    int                    width,
+    int                    height,
     const HomographyState& hom,
     const AppSettings&     settings)
 {
-    FrameResult result;
+    beginFrame();
 
+    // 외부 버퍼를 감싸는 헤더만 생성 (복사/할당 없음)
     cv::Mat grayFrame(height, width, CV_8UC1, const_cast<unsigned char*>(rawData));
 
-    // 왼쪽 패널: Grayscale + 선택점
-    cv::cvtColor(grayFrame, result.leftPanel, cv::COLOR_GRAY2BGR);
-    drawSelectedPoints(result.leftPanel, hom.selectedPoints);
+    // 호모그래피 설정 후엔 타깃 영역만 검출 — ROI 밖 픽셀은 읽지 않는다 (Mat 헤더만 생성)
+    result_.detectionRoi = computeRoi(width, height, hom, settings);
+    if (settings.roiPolygonMask && hom.ready &&
+        result_.detectionRoi != cv::Rect(0, 0, width, height))
+        updatePolygonMask(result_.detectionRoi);
 
-    // 중심점 검출
-    cv::Mat binaryDisplay;
-    result.detectedCenters = detectCenters(grayFrame, binaryDisplay);
+    detectCenters(grayFrame(result_.detectionRoi), settings);
+    transformCenters(hom, settings);
 
-    // 오른쪽 패널: 호모그래피 전 → Binary, 후 → Warped
-    if (hom.ready)
+    endFrame();
+    return result_;
+}
+
+const FrameResult& FrameProcessor::ingestObjects(
+    const SourceObject*    objects,
+    int                    count,
+    int                    width,
+    int                    height,
+    const HomographyState& hom,
+    const AppSettings&     settings)
+{
+    beginFrame();
+    result_.detectionRoi = cv::Rect(0, 0, width, height);
+
+    std::vector<Blob>&        blobs   = result_.blobs;
+    std::vector<cv::Point2f>& centers = result_.detectedCenters;
+    size_t blobsCap   = blobs.capacity();
+    size_t centersCap = centers.capacity();
+    blobs.clear();
+    centers.clear();
+    for (int i = 0; i < count; i++)
     {
-        cv::Mat warpedPanel = buildWarpedPanel(
-            grayFrame, result.detectedCenters, hom, settings, result.inBoundCenters);
-        cv::resize(warpedPanel, result.rightPanel, cv::Size(width, height));
+        const SourceObject& o = objects[i];
+        // 바운딩 박스는 면적과 같은 넓이의 정사각형으로 근사 (표시용)
+        int half = static_cast<int>(std::sqrt(static_cast<float>(std::max(o.area, 1)))) / 2;
+        Blob b;
+        b.cx   = o.x;
+        b.cy   = o.y;
+        b.area = o.area;
+        b.x0   = static_cast<int>(o.x) - half;  b.x1 = static_cast<int>(o.x) + half;
+        b.y0   = static_cast<int>(o.y) - half;  b.y1 = static_cast<int>(o.y) + half;
+        blobs.push_back(b);
+        centers.emplace_back(o.x, o.y);
     }
+    trackVec(blobs, blobsCap);
+    trackVec(centers, centersCap);
+
+    transformCenters(hom, settings);
+
+    endFrame();
+    return result_;
+}
+
+const FrameResult& FrameProcessor::render(
+    const unsigned char*   rawData,
+    int                    width,
+    int                    height,
+    const HomographyState& hom,
+    const AppSettings&     settings)
+{
+    beginFrame();
+
+    cv::Mat grayFrame(height, width, CV_8UC1, const_cast<unsigned char*>(rawData));
+
+    // 왼쪽 패널: Grayscale + 선택점
+    const uchar* leftBefore = result_.leftPanel.data;
+    cv::cvtColor(grayFrame, result_.leftPanel, cv::COLOR_GRAY2BGR);
+    trackMat(result_.leftPanel, leftBefore);
+    drawSelectedPoints(result_.leftPanel, hom.selectedPoints);
+    if (result_.detectionRoi != cv::Rect(0, 0, width, height))
+        cv::rectangle(result_.leftPanel, result_.detectionRoi, cv::Scalar(80, 80, 200), 1);
+
+    // 오른쪽 패널: 호모그래피 전 → Binary, 후 → Warped
+    if (hom.ready)
+        buildWarpedPanel(grayFrame, hom, settings);
     else
-    {
-        result.rightPanel = binaryDisplay;
-    }
+        buildBinaryPanel();
 
     // 오른쪽 패널 왼쪽 상단: 타겟 해상도 표시
     {
-        std::string resText = std::to_string(settings.targetWidth) + " x " + std::to_string(settings.targetHeight);
-        cv::putText(result.rightPanel, resText, cv::Point(11, 26),
+        char resText[32];
+        snprintf(resText, sizeof(resText), "%d x %d", settings.targetWidth, settings.targetHeight);
+        cv::putText(result_.rightPanel, resText, cv::Point(11, 26),
                     cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 0, 0), 2, cv::LINE_AA);
-        cv::putText(result.rightPanel, resText, cv::Point(10, 25),
+        cv::putText(result_.rightPanel, resText, cv::Point(10, 25),
                     cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 220, 220), 1, cv::LINE_AA);
     }
 
-    return result;
+    endFrame();
+    return result_;
+}
+
+const FrameResult& FrameProcessor::process(
+    const unsigned char*   rawData,
+    int                    width,
+    int                    height,
+    const HomographyState& hom,
+    const AppSettings&     settings)
+{
+    detect(rawData, width, height, hom, settings);
+    int detectAllocs = lastFrameAllocs_;
+    render(rawData, width, height, hom, settings);
+    lastFrameAllocs_ += detectAllocs;
+    return result_;
 }
@@ -3,20 +3,135 @@
 #include <opencv2/opencv.hpp>
 #include "homography.h"
 #include "settings.h"
+#include "blob_kernel.h"
+#include "blob_labeler.h"
 
 // ========== 프레임 처리 결과 ==========
 struct FrameResult
 {
     cv::Mat leftPanel;                          // Grayscale 원본 + 선택점 표시
     cv::Mat rightPanel;                         // Binary (호모그래피 전) 또는 Warped 컬러 (후)
-    std::vector<cv::Point2f> detectedCenters;   // 원본에서 검출된 모든 중심점
+    std::vector<Blob>        blobs;             // 검출된 블롭 통계 (detectedCenters 와 같은 순서)
+    std::vector<cv::Point2f> detectedCenters;   // 원본에서 검출된 모든 중심점 (sub-pixel)
     std::vector<cv::Point2f> inBoundCenters;    // 호모그래피 영역 내 중심점 (UDP 전송 대상)
+    std::vector<int>         inBoundAreas;      // inBoundCenters 와 같은 순서의 블롭 면적 (px)
+    cv::Rect                 detectionRoi;      // 실제 검출한 영역 (전체 프레임 또는 4점 ROI)
 };
 
-// raw 프레임 데이터를 받아 처리 결과를 반환
-FrameResult processFrame(
-    const unsigned char* rawData,
-    int                  width,
-    int                  height,
-    const HomographyState& hom,
-    const AppSettings&     settings);
+// ========== 프레임 처리기 ==========
+// 프레임마다 쓰는 cv::Mat / 벡터를 멤버로 보유해 재사용한다.
+// 해상도·타깃 크기가 바뀌지 않는 한 steady-state 프레임은 버퍼를 새로 할당하지 않는다.
+//
+// 검출(detect)과 시각화(render)를 분리:
+//   detect() — 매 프레임: 중심점 검출 + 중심점만 왜곡 제거·perspectiveTransform → inBoundCenters
+//   render() — 표시할 프레임에서만: leftPanel / rightPanel 생성 (헤드리스 모드에선 호출 안 함)
+class FrameProcessor
+{
+public:
+    FrameProcessor();
+
+    // 트래킹 전용 경로. 반환 참조는 다음 detect()/process() 호출 전까지 유효.
+    const FrameResult& detect(
+        const unsigned char*   rawData,
+        int                    width,
+        int                    height,
+        const HomographyState& hom,
+        const AppSettings&     settings);
+
+    // 카메라 객체 모드 경로: 분할(dilate/threshold/라벨링) 없이 카메라가 보고한 객체를
+    // blobs / detectedCenters 로 옮긴 뒤 detect() 와 같은 왜곡 제거·호모그래피 변환만 수행.
+    // 호스트 검출과 달리 ROI 로 자르지 않으며 (카메라는 전체 프레임 분할) 경계 밖 점은 변환 후 걸러짐.
+    const FrameResult& ingestObjects(
+        const SourceObject*    objects,
+        int                    count,
+        int                    width,
+        int                    height,
+        const HomographyState& hom,
+        const AppSettings&     settings);
+
+    // 직전 detect() 결과로 leftPanel / rightPanel 을 채움 (같은 rawData 를 전달해야 함)
+    const FrameResult& render(
+        const unsigned char*   rawData,
+        int                    width,
+        int                    height,
+        const HomographyState& hom,
+        const AppSettings&     settings);
+
+    // detect() + render()
+    const FrameResult& process(
+        const unsigned char*   rawData,
+        int                    width,
+        int                    height,
+        const HomographyState& hom,
+        const AppSettings&     settings);
+
+    // 직전 detect()/render() 에서 처리기 소유 버퍼가 (재)할당된 횟수 (steady-state = 0)
+    int  lastFrameAllocations() const { return lastFrameAllocs_; }
+    long totalAllocations()     const { return totalAllocs_; }
+
+private:
+    void selectKernel(BlobKernel requested);
+    const std::vector<cv::Point2f>& detectionOutline(const HomographyState& hom, const AppSettings& settings);
+    cv::Rect computeRoi(int width, int height, const HomographyState& hom,
+                        const AppSettings& settings);
+    void updatePolygonMask(const cv::Rect& roi);
+    void detectCenters(const cv::Mat& gray, const AppSettings& settings);
+    void transformCenters(const HomographyState& hom, const AppSettings& settings);
+    void buildBinaryPanel();
+    void updateWarpMaps(const HomographyState& hom, const AppSettings& settings,
+                        int panelWidth, int panelHeight);
+    void buildWarpedPanel(const cv::Mat& gray, const HomographyState& hom,
+                          const AppSettings& settings);
+
+    // 버퍼 할당 추적: 연산 전 data/capacity 를 기억해 두었다가 바뀌면 카운트
+    void trackMat(const cv::Mat& m, const uchar* before);
+    template <typename T>
+    void trackVec(const std::vector<T>& v, size_t capacityBefore)
+    {
+        if (v.capacity() != capacityBefore) ++frameAllocs_;
+    }
+    void beginFrame() { frameAllocs_ = 0; }
+    void endFrame();
+
+    FrameResult result_;
+
+    // 스크래치 버퍼
+    cv::Mat kernel_;
+    cv::Mat dilated_;               // BlobKernel::OpenCV 경로 전용
+    cv::Mat binary_;
+    cv::Mat warped_;                // 패널 크기의 warp 미리보기 (grayscale)
+    // 패널 픽셀 → 원본 픽셀 remap 테이블 (고정소수점: CV_16SC2 정수 좌표 + CV_16UC1 보간 계수).
+    // 호모그래피/타깃 크기/패널 크기가 바뀔 때만 다시 만든다.
+    cv::Mat warpMapXY_;
+    cv::Mat warpMapFrac_;
+    cv::Mat warpMapXf_;             // 테이블 생성용 float 맵 (재생성 시에만 사용)
+    cv::Mat warpMapYf_;
+    cv::Matx33d warpMapHom_;
+    cv::Size    warpMapTarget_;
+    LensModel   warpMapLens_;
+    // 타깃 영역 외곽선 (원본 카메라 픽셀). 렌즈 보정이 꺼져 있으면 4 코너, 켜져 있으면 타깃 사각형
+    // 변을 샘플링해 역호모그래피 → 렌즈 왜곡을 적용한 곡선 (직선 변이 원본 영상에서 휘는 만큼 포함).
+    // 코너/호모그래피/렌즈가 바뀔 때만 다시 계산.
+    std::vector<cv::Point2f> outline_;
+    std::vector<cv::Point2f> outlineCorners_;
+    cv::Matx33d              outlineHom_;
+    LensModel                outlineLens_;
+    bool                     outlineValid_ = false;
+    cv::Mat polyMask_;              // ROI 크기의 외곽선 다각형 마스크 (외곽선/ROI 변경 시에만 갱신)
+    std::vector<cv::Point2f> polyMaskCorners_;  // 마스크를 그린 외곽선
+    cv::Rect                 polyMaskRoi_;
+    std::vector<cv::Point>   polyPoints_;
+    BlobLabeler              labeler_;
+    std::vector<cv::Point2f> undistorted_;     // 렌즈 보정된 중심점 (lens_undistort=1 일 때만)
+    std::vector<cv::Point2f> transformed_;
+    std::vector<uint8_t>     kernelScratch_;   // 융합 커널 7행 링 버퍼
+
+    // 요청된/실제 사용 중인 Dilate+Threshold 구현 (설정 변경 시에만 재선택)
+    BlobKernel requestedKernel_ = BlobKernel::Auto;
+    BlobKernel activeKernel_    = BlobKernel::OpenCV;
+    bool       kernelSelected_  = false;
+
+    int  frameAllocs_     = 0;
+    int  lastFrameAllocs_ = 0;
+    long totalAllocs_     = 0;
+};
@@ -0,0 +1,640 @@
+#include "frame_recorder.h"
+#include "spsc_ring.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#ifdef IRTRACKING_WITH_LZ4
+#include <lz4.h>
+#endif
+
+// 수 GB 녹화 파일 대응 (long 이 32비트인 Windows 의 fseek 대신)
+static bool seek64(FILE* f, uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(f, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(f, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+bool isFrameRecordingFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    char magic[4] = {};
+    return in.read(magic, sizeof(magic)) && memcmp(magic, "IRRC", 4) == 0;
+}
+
+bool frameRecorderHasLz4()
+{
+#ifdef IRTRACKING_WITH_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ─────────────────────────────────────────────────────────
+//  FrameRecorder
+// ─────────────────────────────────────────────────────────
+
+// 청크 버퍼 하나의 채움 상태 (처리 스레드가 채우고, 링으로 넘긴 뒤엔 기록 스레드만 읽음)
+struct ChunkFill
+{
+    size_t   used       = 0;
+    uint32_t firstFrame = 0;
+    uint32_t frameCount = 0;
+};
+
+struct FrameRecorder::Session
+{
+    FILE*       file          = nullptr;
+    std::string path;
+    int         width         = 0;
+    int         height        = 0;
+    int         chunkFrames   = 0;
+    uint32_t    flags         = 0;
+    size_t      frameCapacity = 0;      // 프레임 하나 최대 크기 (헤더 + 픽셀 + 중심점)
+    bool        lz4           = false;
+
+    std::vector<std::vector<uint8_t>>             buffers;
+    std::vector<ChunkFill>                        fills;
+    SpscRing<int, FrameRecorder::MAX_BUFFERS>     freeBuffers;    // 기록 → 처리
+    SpscRing<int, FrameRecorder::MAX_BUFFERS>     filled;         // 처리 → 기록
+
+    // 처리 스레드 전용
+    int      current    = -1;           // 채우는 중인 청크 버퍼
+    size_t   frameStart = 0;            // 현재 프레임 헤더 위치 (청크 안)
+    uint32_t nextFrame  = 0;
+
+    // 기록 스레드 전용
+    std::vector<uint8_t>          compressed;
+    std::vector<RecordIndexEntry> index;
+    uint64_t                      fileOffset = 0;
+    bool                          writeFailed = false;
+
+    std::thread             writer;
+    std::mutex              wakeMutex;
+    std::condition_variable wakeCv;
+    std::atomic<bool>       stopping{false};
+};
+
+FrameRecorder::FrameRecorder() = default;
+
+FrameRecorder::~FrameRecorder()
+{
+    stop();
+}
+
+bool FrameRecorder::start(const std::string& path, int width, int height, bool objectMode,
+                          const FrameRecorderOptions& options, std::string& errorOut)
+{
+    if (active_.load())
+    {
+        errorOut = "Already recording";
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f)
+    {
+        errorOut = "Cannot create recording file: " + path;
+        return false;
+    }
+    setvbuf(f, nullptr, _IONBF, 0);         // 청크 단위로 직접 큰 쓰기 (stdio 버퍼 복사 생략)
+
+    std::unique_ptr<Session> s(new Session());
+    s->file          = f;
+    s->path          = path;
+    s->width         = width;
+    s->height        = height;
+    s->chunkFrames   = std::max(1, std::min(MAX_CHUNK_FRAMES, options.chunkFrames));
+    s->flags         = objectMode ? static_cast<uint32_t>(RECORD_FLAG_OBJECTS) : 0u;
+    s->frameCapacity = sizeof(RecordFrameHeader) + static_cast<size_t>(width) * height +
+                       MAX_SOURCE_OBJECTS * sizeof(ObjectRecord);
+    s->lz4           = options.lz4 && frameRecorderHasLz4();
+    if (options.lz4 && !s->lz4)
+        std::cerr << "[Recorder] LZ4 not built (IRTRACKING_WITH_LZ4); recording uncompressed." << std::endl;
+
+    // 모든 버퍼를 여기서 한 번만 할당 (녹화 중 처리/기록 스레드는 할당하지 않음)
+    int    bufferCount = std::max(2, std::min(MAX_BUFFERS, options.buffers));
+    size_t chunkBytes  = s->frameCapacity * s->chunkFrames;
+    s->buffers.resize(bufferCount);
+    s->fills.resize(bufferCount);
+    for (int i = 0; i < bufferCount; i++)
+    {
+        s->buffers[i].resize(chunkBytes);
+        s->freeBuffers.push(i);
+    }
+#ifdef IRTRACKING_WITH_LZ4
+    if (s->lz4) s->compressed.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(chunkBytes))));
+#endif
+    s->index.reserve(4096);
+
+    RecordFileHeader hdr = {};
+    memcpy(hdr.magic, "IRRC", 4);
+    hdr.version     = 1;
+    hdr.width       = static_cast<uint32_t>(width);
+    hdr.height      = static_cast<uint32_t>(height);
+    hdr.chunkFrames = static_cast<uint32_t>(s->chunkFrames);
+    hdr.flags       = s->flags;
+    if (fwrite(&hdr, sizeof(hdr), 1, f) != 1)
+    {
+        fclose(f);
+        errorOut = "Cannot write recording file: " + path;
+        return false;
+    }
+    s->fileOffset = sizeof(hdr);
+
+    frames_.store(0);
+    drops_.store(0);
+    bytes_.store(sizeof(hdr));
+
+    std::cout << "[Recorder] Recording to " << path << " (" << width << "x" << height << ", "
+              << s->chunkFrames << " frames/chunk x " << bufferCount << " buffers = "
+              << (chunkBytes * bufferCount) / (1024 * 1024) << " MB"
+              << (s->lz4 ? ", LZ4" : "") << ")" << std::endl;
+
+    session_ = std::move(s);
+    session_->writer = std::thread(&FrameRecorder::writerLoop, this);
+    active_.store(true);
+    return true;
+}
+
+void FrameRecorder::stop()
+{
+    if (!session_) return;
+
+    // 처리 스레드가 beginFrame ~ endFrame 사이면 끝날 때까지 (프레임 하나) 대기
+    active_.store(false);
+    while (inFrame_.load()) std::this_thread::yield();
+
+    Session& s = *session_;
+    // 채우다 만 청크는 처리 스레드가 멈췄으니 여기서 대신 넘김 (빈 청크는 세션과 함께 버림)
+    if (s.current >= 0 && s.fills[s.current].frameCount > 0)
+        s.filled.push(s.current);
+    s.current = -1;
+
+    s.stopping.store(true);
+    s.wakeCv.notify_one();
+    s.writer.join();
+
+    // 색인 + 헤더 갱신
+    RecordIndexHeader ih;
+    memcpy(ih.magic, "IRIX", 4);
+    ih.chunkCount = static_cast<uint32_t>(s.index.size());
+    uint64_t indexOffset = s.fileOffset;
+    bool     ok = !s.writeFailed &&
+                  fwrite(&ih, sizeof(ih), 1, s.file) == 1 &&
+                  (s.index.empty() ||
+                   fwrite(s.index.data(), sizeof(RecordIndexEntry), s.index.size(), s.file) == s.index.size());
+
+    uint32_t frameCount = 0;
+    for (const RecordIndexEntry& e : s.index) frameCount += e.frameCount;
+    if (ok)
+    {
+        RecordFileHeader hdr = {};
+        memcpy(hdr.magic, "IRRC", 4);
+        hdr.version     = 1;
+        hdr.width       = static_cast<uint32_t>(s.width);
+        hdr.height      = static_cast<uint32_t>(s.height);
+        hdr.chunkFrames = static_cast<uint32_t>(s.chunkFrames);
+        hdr.flags       = s.flags;
+        hdr.frameCount  = frameCount;
+        hdr.chunkCount  = ih.chunkCount;
+        hdr.indexOffset = indexOffset;
+        ok = seek64(s.file, 0) && fwrite(&hdr, sizeof(hdr), 1, s.file) == 1;
+    }
+    fclose(s.file);
+
+    if (ok)
+        std::cout << "[Recorder] Recorded " << frameCount << " frame(s) in " << s.index.size() << " chunk(s), "
+                  << bytes_.load() / (1024 * 1024) << " MB, dropped " << drops_.load() << ": " << s.path << std::endl;
+    else
+        std::cerr << "[Recorder] Write error; " << s.path << " has no index (readers rebuild it from chunks)." << std::endl;
+    session_.reset();
+}
+
+void FrameRecorder::beginFrame(const uint8_t* pixels, int width, int height, uint32_t frameId,
+                               double timestamp, uint64_t captureTimeUs)
+{
+    framePending_ = false;
+    inFrame_.store(true);
+    if (!active_.load())
+    {
+        inFrame_.store(false);
+        return;
+    }
+
+    Session& s = *session_;
+    if (pixels && (width != s.width || height != s.height))
+    {
+        drops_.fetch_add(1, std::memory_order_relaxed);
+        inFrame_.store(false);
+        return;
+    }
+    if (s.current < 0)
+    {
+        // 빈 버퍼가 없으면 기록 스레드가 밀린 것 — 기다리지 않고 이 프레임을 버림
+        if (!s.freeBuffers.pop(s.current))
+        {
+            s.current = -1;
+            drops_.fetch_add(1, std::memory_order_relaxed);
+            inFrame_.store(false);
+            return;
+        }
+        s.fills[s.current] = ChunkFill{ 0, s.nextFrame, 0 };
+    }
+
+    ChunkFill& fill = s.fills[s.current];
+    uint8_t*   dst  = s.buffers[s.current].data() + fill.used;
+
+    RecordFrameHeader fh;
+    fh.timestampUs   = timestamp > 0.0 ? static_cast<uint64_t>(timestamp * 1e6 + 0.5) : 0;
+    fh.captureTimeUs = captureTimeUs;
+    fh.frameId       = frameId;
+    fh.pixelBytes    = pixels ? static_cast<uint32_t>(width) * height : 0;
+    fh.objectCount   = 0;
+    fh.reserved      = 0;
+    memcpy(dst, &fh, sizeof(fh));
+    if (pixels) memcpy(dst + sizeof(fh), pixels, fh.pixelBytes);
+
+    s.frameStart  = fill.used;
+    fill.used    += sizeof(fh) + fh.pixelBytes;
+    framePending_ = true;
+    // inFrame_ 은 endFrame() 에서 내림
+}
+
+void FrameRecorder::endFrame(const std::vector<Blob>& blobs)
+{
+    if (!framePending_) return;
+    framePending_ = false;
+
+    Session&   s    = *session_;
+    ChunkFill& fill = s.fills[s.current];
+    uint8_t*   buf  = s.buffers[s.current].data();
+
+    uint32_t count = static_cast<uint32_t>(std::min<size_t>(blobs.size(), MAX_SOURCE_OBJECTS));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ObjectRecord r{ blobs[i].cx, blobs[i].cy, static_cast<uint32_t>(blobs[i].area) };
+        memcpy(buf + fill.used, &r, sizeof(r));
+        fill.used += sizeof(r);
+    }
+    memcpy(buf + s.frameStart + offsetof(RecordFrameHeader, objectCount), &count, sizeof(count));
+
+    ++fill.frameCount;
+    ++s.nextFrame;
+    frames_.fetch_add(1, std::memory_order_relaxed);
+
+    if (static_cast<int>(fill.frameCount) == s.chunkFrames)
+    {
+        // 버퍼 수 ≤ 링 용량이라 push 는 실패하지 않음
+        s.filled.push(s.current);
+        s.current = -1;
+        s.wakeCv.notify_one();
+    }
+    inFrame_.store(false);
+}
+
+void FrameRecorder::writerLoop()
+{
+    Session& s = *session_;
+    for (;;)
+    {
+        int buffer;
+        if (s.filled.pop(buffer))
+        {
+            writeChunk(buffer);
+            s.freeBuffers.push(buffer);
+            continue;
+        }
+        if (s.stopping.load() && s.filled.empty()) break;
+
+        // 링은 lock-free, 대기만 condvar (알림을 놓쳐도 짧은 타임아웃으로 다시 확인)
+        std::unique_lock<std::mutex> lock(s.wakeMutex);
+        s.wakeCv.wait_for(lock, std::chrono::milliseconds(20));
+    }
+}
+
+void FrameRecorder::writeChunk(int buffer)
+{
+    Session&         s    = *session_;
+    const ChunkFill& fill = s.fills[buffer];
+    if (s.writeFailed) return;      // 디스크 오류 뒤에는 버퍼만 돌려줌 (처리 스레드는 계속 동작)
+
+    RecordChunkHeader ch;
+    memcpy(ch.magic, "IRCK", 4);
+    ch.codec      = RECORD_CODEC_RAW;
+    ch.firstFrame = fill.firstFrame;
+    ch.frameCount = fill.frameCount;
+    ch.rawSize    = static_cast<uint32_t>(fill.used);
+    ch.storedSize = static_cast<uint32_t>(fill.used);
+
+    const uint8_t* payload = s.buffers[buffer].data();
+#ifdef IRTRACKING_WITH_LZ4
+    if (s.lz4)
+    {
+        int n = LZ4_compress_default(reinterpret_cast<const char*>(payload),
+                                     reinterpret_cast<char*>(s.compressed.data()),
+                                     static_cast<int>(fill.used), static_cast<int>(s.compressed.size()));
+        // 압축 이득이 없으면 (노출 과다 등) 원본 그대로
+        if (n > 0 && static_cast<size_t>(n) < fill.used)
+        {
+            ch.codec      = RECORD_CODEC_LZ4;
+            ch.storedSize = static_cast<uint32_t>(n);
+            payload       = s.compressed.data();
+        }
+    }
+#endif
+
+    if (fwrite(&ch, sizeof(ch), 1, s.file) != 1 ||
+        fwrite(payload, 1, ch.storedSize, s.file) != ch.storedSize)
+    {
+        s.writeFailed = true;
+        std::cerr << "[Recorder] Write failed (disk full?): " << s.path << std::endl;
+        return;
+    }
+
+    s.index.push_back({ s.fileOffset, ch.firstFrame, ch.frameCount });
+    s.fileOffset += sizeof(ch) + ch.storedSize;
+    bytes_.fetch_add(sizeof(ch) + ch.storedSize, std::memory_order_relaxed);
+}
+
+// ─────────────────────────────────────────────────────────
+//  FrameRecordingReader
+// ─────────────────────────────────────────────────────────
+
+std::unique_ptr<FrameRecordingReader> FrameRecordingReader::open(const std::string& path,
+                                                                 std::string& errorOut)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+    {
+        errorOut = "Cannot open recording file: " + path;
+        return nullptr;
+    }
+    std::unique_ptr<FrameRecordingReader> r(new FrameRecordingReader());
+    r->file_ = f;
+
+    RecordFileHeader hdr;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || memcmp(hdr.magic, "IRRC", 4) != 0 || hdr.version != 1 ||
+        hdr.width == 0 || hdr.height == 0)
+    {
+        errorOut = "Invalid recording file header: " + path;
+        return nullptr;
+    }
+    r->width_  = static_cast<int>(hdr.width);
+    r->height_ = static_cast<int>(hdr.height);
+    r->flags_  = hdr.flags;
+
+    // 1) 파일 끝 색인
+    bool indexed = false;
+    if (hdr.indexOffset != 0 && seek64(f, hdr.indexOffset))
+    {
+        RecordIndexHeader ih;
+        if (fread(&ih, sizeof(ih), 1, f) == 1 && memcmp(ih.magic, "IRIX", 4) == 0)
+        {
+            r->index_.resize(ih.chunkCount);
+            indexed = ih.chunkCount == 0 ||
+                      fread(r->index_.data(), sizeof(RecordIndexEntry), ih.chunkCount, f) == ih.chunkCount;
+        }
+    }
+
+    // 2) 색인이 없으면 (녹화 중 비정상 종료) 청크 헤더를 차례로 훑음
+    if (!indexed)
+    {
+        r->index_.clear();
+        uint64_t pos = sizeof(hdr);
+        RecordChunkHeader ch;
+        while (seek64(f, pos) && fread(&ch, sizeof(ch), 1, f) == 1 && memcmp(ch.magic, "IRCK", 4) == 0)
+        {
+            // 본문이 끝까지 있는지 확인 (마지막 바이트를 읽어 봄)
+            uint8_t last;
+            if (ch.storedSize == 0 || !seek64(f, pos + sizeof(ch) + ch.storedSize - 1) || fread(&last, 1, 1, f) != 1)
+                break;
+            r->index_.push_back({ pos, ch.firstFrame, ch.frameCount });
+            pos += sizeof(ch) + ch.storedSize;
+        }
+        std::cerr << "[Recording] " << path << " has no index; rebuilt from " << r->index_.size()
+                  << " chunk(s)." << std::endl;
+    }
+
+    for (const RecordIndexEntry& e : r->index_) r->frameCount_ += e.frameCount;
+    if (r->frameCount_ == 0)
+    {
+        errorOut = "Recording file contains no frames: " + path;
+        return nullptr;
+    }
+    return r;
+}
+
+FrameRecordingReader::~FrameRecordingReader()
+{
+    if (file_) fclose(file_);
+}
+
+bool FrameRecordingReader::loadChunk(size_t chunk, std::string& errorOut)
+{
+    if (chunk == loadedChunk_) return true;
+    loadedChunk_ = SIZE_MAX;
+
+    RecordChunkHeader ch;
+    if (!seek64(file_, index_[chunk].fileOffset) || fread(&ch, sizeof(ch), 1, file_) != 1 ||
+        memcmp(ch.magic, "IRCK", 4) != 0)
+    {
+        errorOut = "Corrupt chunk header";
+        return false;
+    }
+    stored_.resize(ch.storedSize);
+    if (fread(stored_.data(), 1, ch.storedSize, file_) != ch.storedSize)
+    {
+        errorOut = "Truncated chunk";
+        return false;
+    }
+
+    if (ch.codec == RECORD_CODEC_RAW)
+    {
+        chunk_.swap(stored_);
+    }
+    else if (ch.codec == RECORD_CODEC_LZ4)
+    {
+#ifdef IRTRACKING_WITH_LZ4
+        chunk_.resize(ch.rawSize);
+        int n = LZ4_decompress_safe(reinterpret_cast<const char*>(stored_.data()),
+                                    reinterpret_cast<char*>(chunk_.data()),
+                                    static_cast<int>(ch.storedSize), static_cast<int>(ch.rawSize));
+        if (n != static_cast<int>(ch.rawSize))
+        {
+            errorOut = "LZ4 decompression failed";
+            return false;
+        }
+#else
+        errorOut = "Recording uses LZ4 but this build has no LZ4 support (IRTRACKING_WITH_LZ4)";
+        return false;
+#endif
+    }
+    else
+    {
+        errorOut = "Unknown chunk codec " + std::to_string(ch.codec);
+        return false;
+    }
+    loadedChunk_ = chunk;
+    return true;
+}
+
+bool FrameRecordingReader::readFrame(uint32_t index, RecordedFrame& out, std::string& errorOut)
+{
+    if (index >= frameCount_)
+    {
+        errorOut = "Frame " + std::to_string(index) + " out of range";
+        return false;
+    }
+
+    // firstFrame 기준 이진 탐색 → 그 청크 안에서 프레임 레코드를 건너뜀 (헤더만 읽음)
+    auto it = std::upper_bound(index_.begin(), index_.end(), index,
+                               [](uint32_t i, const RecordIndexEntry& e) { return i < e.firstFrame; });
+    if (it == index_.begin()) { errorOut = "Frame not indexed"; return false; }
+    --it;
+    if (index - it->firstFrame >= it->frameCount) { errorOut = "Frame not indexed"; return false; }
+    if (!loadChunk(static_cast<size_t>(it - index_.begin()), errorOut)) return false;
+
+    size_t pos = 0;
+    for (uint32_t skip = index - it->firstFrame; ; --skip)
+    {
+        RecordFrameHeader fh;
+        if (pos + sizeof(fh) > chunk_.size()) { errorOut = "Corrupt chunk"; return false; }
+        memcpy(&fh, chunk_.data() + pos, sizeof(fh));
+        size_t size = sizeof(fh) + fh.pixelBytes + static_cast<size_t>(fh.objectCount) * sizeof(ObjectRecord);
+        if (pos + size > chunk_.size()) { errorOut = "Corrupt chunk"; return false; }
+        if (skip == 0)
+        {
+            out.frameId       = fh.frameId;
+            out.timestampUs   = fh.timestampUs;
+            out.captureTimeUs = fh.captureTimeUs;
+            out.pixels        = fh.pixelBytes ? chunk_.data() + pos + sizeof(fh) : nullptr;
+            out.objects       = reinterpret_cast<const ObjectRecord*>(chunk_.data() + pos + sizeof(fh) + fh.pixelBytes);
+            out.objectCount   = static_cast<int>(fh.objectCount);
+            if (out.pixels && fh.pixelBytes != static_cast<uint32_t>(width_) * height_)
+            {
+                errorOut = "Frame size mismatch";
+                return false;
+            }
+            return true;
+        }
+        pos += size;
+    }
+}
+
+// ─────────────────────────────────────────────────────────
+//  FrameRecordingSource
+// ─────────────────────────────────────────────────────────
+
+std::unique_ptr<FrameRecordingSource> FrameRecordingSource::open(const std::string& path,
+                                                                 ReplayPacing pacing,
+                                                                 bool loop,
+                                                                 std::string& errorOut)
+{
+    std::unique_ptr<FrameRecordingReader> reader = FrameRecordingReader::open(path, errorOut);
+    if (!reader) return nullptr;
+
+    std::unique_ptr<FrameRecordingSource> src(new FrameRecordingSource());
+    src->reader_ = std::move(reader);
+    src->objects_.reserve(MAX_SOURCE_OBJECTS);
+    src->pacing_ = pacing;
+    src->loop_   = loop;
+
+    std::cout << "[Replay] " << path << ": " << src->reader_->frameCount() << " recorded frames, "
+              << src->reader_->width() << "x" << src->reader_->height()
+              << (src->reader_->objectMode() ? " (object mode)" : "")
+              << (pacing == ReplayPacing::Realtime ? " (realtime)" : " (as fast as possible)")
+              << (loop ? " (loop)" : "") << std::endl;
+    return src;
+}
+
+bool FrameRecordingSource::nextFrame(SourceFrame& out)
+{
+    if (finished_) return false;
+
+    if (next_ >= reader_->frameCount())
+    {
+        if (!loop_)
+        {
+            finished_ = true;
+            std::cout << "[Replay] End of recording reached." << std::endl;
+            return false;
+        }
+        next_ = 0;
+    }
+
+    RecordedFrame rf;
+    std::string   error;
+    if (!reader_->readFrame(next_, rf, error))
+    {
+        finished_ = true;
+        std::cerr << "[Replay] Recording frame " << next_ << ": " << error << std::endl;
+        return false;
+    }
+
+    // SDK 타임스탬프가 없던 소스는 캡처 시각으로 간격 재현
+    uint64_t tsUs = rf.timestampUs ? rf.timestampUs : rf.captureTimeUs;
+    if (pacing_ == ReplayPacing::Realtime)
+    {
+        if (next_ == 0)
+        {
+            wallStart_ = std::chrono::steady_clock::now();
+            firstTsUs_ = tsUs;
+        }
+        uint64_t offsetUs = tsUs >= firstTsUs_ ? tsUs - firstTsUs_ : 0;
+        std::this_thread::sleep_until(wallStart_ + std::chrono::microseconds(offsetUs));
+    }
+
+    out.data        = rf.pixels;
+    out.objects     = nullptr;
+    out.objectCount = 0;
+    if (!rf.pixels)
+    {
+        int count = std::min(rf.objectCount, MAX_SOURCE_OBJECTS);
+        objects_.clear();
+        for (int i = 0; i < count; i++)
+        {
+            ObjectRecord r;
+            memcpy(&r, rf.objects + i, sizeof(r));
+            objects_.push_back({ r.x, r.y, static_cast<int>(r.area) });
+        }
+        out.objects     = objects_.data();
+        out.objectCount = count;
+    }
+    out.width     = reader_->width();
+    out.height    = reader_->height();
+    out.frameId   = rf.frameId;
+    out.timestamp = static_cast<double>(tsUs) * 1e-6;
+    ++next_;
+    return true;
+}
+
+// ─────────────────────────────────────────────────────────
+//  openRecording
+// ─────────────────────────────────────────────────────────
+
+std::unique_ptr<IFrameSource> openRecording(const std::string& path, ReplayPacing pacing,
+                                            bool loop, std::string& errorOut)
+{
+    if (isObjectListFile(path))
+        return ObjectReplaySource::open(path, pacing, loop, errorOut);
+    if (isFrameRecordingFile(path))
+        return FrameRecordingSource::open(path, pacing, loop, errorOut);
+    return ReplayFrameSource::open(path, pacing, loop, errorOut);
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "blob_labeler.h"
+#include "frame_source.h"
+#include "object_list.h"
+#include "replay_source.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ========== 원시 프레임 녹화 파일 포맷 (.irrec) ==========
+// [RecordFileHeader]
+// + 청크 × ( [RecordChunkHeader] + 본문 storedSize 바이트 (codec 이 LZ4 면 압축, 풀면 rawSize) )
+// + [RecordIndexHeader] + chunkCount × [RecordIndexEntry]
+// 청크 본문 = frameCount × ( [RecordFrameHeader] + pixelBytes 바이트 grayscale + objectCount × [ObjectRecord] )
+// 색인은 녹화를 멈출 때 파일 끝에 쓰고 헤더의 indexOffset 을 채운다. indexOffset == 0 (비정상 종료) 이면
+// 읽는 쪽이 청크 헤더를 차례로 훑어 색인을 다시 만든다 (잘린 마지막 청크는 버림). 모든 정수는 little-endian.
+// 좌표는 원본 카메라 픽셀 (렌즈 보정·호모그래피 전) — .irraw / .irobj 와 같은 좌표계.
+#pragma pack(push, 1)
+struct RecordFileHeader
+{
+    char     magic[4];      // "IRRC"
+    uint32_t version;       // 1
+    uint32_t width;
+    uint32_t height;
+    uint32_t chunkFrames;   // 청크당 최대 프레임 수
+    uint32_t flags;         // RECORD_FLAG_*
+    uint32_t frameCount;    // 색인이 있을 때만 유효
+    uint32_t chunkCount;
+    uint64_t indexOffset;   // 0 = 색인 없음 (녹화 중 / 비정상 종료)
+};
+
+struct RecordChunkHeader
+{
+    char     magic[4];      // "IRCK"
+    uint32_t codec;         // RecordCodec
+    uint32_t firstFrame;    // 파일 안 프레임 번호 (0부터)
+    uint32_t frameCount;
+    uint32_t rawSize;
+    uint32_t storedSize;
+};
+
+struct RecordFrameHeader
+{
+    uint64_t timestampUs;   // 카메라 SDK 타임스탬프 (µs, 없으면 0)
+    uint64_t captureTimeUs; // 캡처 스레드가 받은 시각 (system_clock µs)
+    uint32_t frameId;
+    uint32_t pixelBytes;    // width*height 또는 0 (객체 모드 프레임)
+    uint32_t objectCount;   // 이 프레임의 검출 중심점 (호스트 검출 / 카메라 객체)
+    uint32_t reserved;
+};
+
+struct RecordIndexHeader
+{
+    char     magic[4];      // "IRIX"
+    uint32_t chunkCount;
+};
+
+struct RecordIndexEntry
+{
+    uint64_t fileOffset;    // RecordChunkHeader 위치
+    uint32_t firstFrame;
+    uint32_t frameCount;
+};
+#pragma pack(pop)
+
+enum RecordCodec : uint32_t
+{
+    RECORD_CODEC_RAW = 0,
+    RECORD_CODEC_LZ4 = 1,
+};
+
+enum RecordFlags : uint32_t
+{
+    RECORD_FLAG_OBJECTS = 1,    // 카메라 객체 모드 소스 (픽셀 없는 프레임 + 가끔 미리보기 grayscale)
+};
+
+// 파일 앞 4바이트가 "IRRC" 인지 (--replay 가 포맷을 구분할 때 사용)
+bool isFrameRecordingFile(const std::string& path);
+
+// 녹화 파일을 포맷에 맞는 재생 소스로 연다: .irobj → ObjectReplaySource, .irrec → FrameRecordingSource,
+// 그 외 → ReplayFrameSource (.irraw). 확장자가 아니라 파일 앞 magic 으로 판별. 실패 시 nullptr + errorOut.
+// --replay 와 보정 도구(LensCalibration / HomographyCalibration)가 같이 사용.
+std::unique_ptr<IFrameSource> openRecording(const std::string& path, ReplayPacing pacing,
+                                            bool loop, std::string& errorOut);
+
+// LZ4 지원 빌드인지 (IRTRACKING_WITH_LZ4)
+bool frameRecorderHasLz4();
+
+// ========== 녹화 설정 (setting.cfg: record_chunk_frames, record_buffers, record_lz4) ==========
+struct FrameRecorderOptions
+{
+    int  chunkFrames = 8;       // 청크당 프레임 수 (한 번에 쓰는 단위)
+    int  buffers     = 8;       // 미리 할당하는 청크 버퍼 수 (기록 스레드가 밀릴 때 흡수할 여유)
+    bool lz4         = true;    // LZ4 지원 빌드에서만 적용 (IR 영상은 대부분 검은색이라 압축률이 높음)
+};
+
+// ========== 비동기 원시 프레임 녹화기 ==========
+// 카메라(파이프라인)마다 하나. 처리 스레드는 미리 할당된 청크 버퍼에 프레임을 memcpy 만 하고,
+// 청크가 차면 인덱스를 링으로 넘긴다. 기록 스레드가 청크를 (선택적으로) LZ4 압축해 큰 순차 쓰기로 기록한다.
+// 빈 청크 버퍼가 없으면 그 프레임은 버리고 (droppedFrames) 처리 스레드는 절대 기다리지 않는다.
+//
+//   GUI 스레드   : start() / stop() / 통계
+//   처리 스레드  : beginFrame() (검출 전 원본 픽셀) → endFrame() (검출 중심점)
+//   기록 스레드  : 압축 + fwrite, 청크 버퍼 반환
+class FrameRecorder
+{
+public:
+    static constexpr int MAX_BUFFERS      = 32;
+    static constexpr int MAX_CHUNK_FRAMES = 64;
+
+    FrameRecorder();
+    ~FrameRecorder();
+
+    // 파일 생성 (상위 폴더 자동 생성) + 버퍼 할당 + 기록 스레드 시작. 실패 시 false + errorOut.
+    bool start(const std::string& path, int width, int height, bool objectMode,
+               const FrameRecorderOptions& options, std::string& errorOut);
+
+    // 처리 중인 프레임이 끝나길 기다린 뒤 남은 청크를 모두 쓰고 색인을 기록해 닫음 (GUI 스레드만 잠깐 블로킹).
+    // 녹화 중이 아니면 아무것도 안 함.
+    void stop();
+
+    bool recording() const { return active_.load(); }
+
+    // 처리 스레드 전용. pixels == nullptr 이면 픽셀 없이 중심점만 기록 (객체 모드).
+    void beginFrame(const uint8_t* pixels, int width, int height, uint32_t frameId,
+                    double timestamp, uint64_t captureTimeUs);
+    void endFrame(const std::vector<Blob>& blobs);
+
+    long     framesRecorded() const { return frames_.load(std::memory_order_relaxed); }
+    long     droppedFrames()  const { return drops_.load(std::memory_order_relaxed); }
+    uint64_t bytesWritten()   const { return bytes_.load(std::memory_order_relaxed); }
+
+private:
+    struct Session;
+
+    void writerLoop();
+    void writeChunk(int buffer);
+
+    std::unique_ptr<Session> session_;     // start() ~ stop() 사이에만 존재
+    bool                     framePending_ = false;    // 처리 스레드 전용: beginFrame 이 청크에 자리를 잡았음
+
+    // active_ / inFrame_ 는 seq_cst: stop() 이 active_ 를 내린 뒤 inFrame_ 이 풀리면
+    // 처리 스레드는 더 이상 session_ 을 건드리지 않는다.
+    std::atomic<bool> active_{false};
+    std::atomic<bool> inFrame_{false};
+
+    std::atomic<long>     frames_{0};
+    std::atomic<long>     drops_{0};
+    std::atomic<uint64_t> bytes_{0};
+};
+
+// ========== 녹화 파일 읽기 (프레임 번호로 임의 접근) ==========
+struct RecordedFrame
+{
+    uint32_t            frameId       = 0;
+    uint64_t            timestampUs   = 0;
+    uint64_t            captureTimeUs = 0;
+    const uint8_t*      pixels        = nullptr;   // width*height, 없으면 nullptr (다음 readFrame 까지 유효)
+    const ObjectRecord* objects       = nullptr;   // objectCount 개 (다음 readFrame 까지 유효)
+    int                 objectCount   = 0;
+};
+
+class FrameRecordingReader
+{
+public:
+    // 색인이 없으면 청크 헤더를 훑어 재구성. 실패 시 nullptr + errorOut.
+    static std::unique_ptr<FrameRecordingReader> open(const std::string& path, std::string& errorOut);
+    ~FrameRecordingReader();
+
+    int      width()      const { return width_; }
+    int      height()     const { return height_; }
+    bool     objectMode() const { return (flags_ & RECORD_FLAG_OBJECTS) != 0; }
+    uint32_t frameCount() const { return frameCount_; }
+
+    // index: 파일 안 프레임 번호 (0 ~ frameCount-1). 같은 청크 안 연속 접근은 압축을 다시 풀지 않음.
+    bool readFrame(uint32_t index, RecordedFrame& out, std::string& errorOut);
+
+private:
+    FrameRecordingReader() = default;
+
+    bool loadChunk(size_t chunk, std::string& errorOut);
+
+    FILE*                         file_       = nullptr;
+    int                           width_      = 0;
+    int                           height_     = 0;
+    uint32_t                      flags_      = 0;
+    uint32_t                      frameCount_ = 0;
+    std::vector<RecordIndexEntry> index_;
+    std::vector<uint8_t>          stored_;              // 읽은 청크 본문 (압축 상태)
+    std::vector<uint8_t>          chunk_;               // 풀린 청크 본문
+    size_t                        loadedChunk_ = SIZE_MAX;
+};
+
+// ========== 녹화 파일 재생 프레임 소스 ==========
+// 픽셀이 있는 프레임은 grayscale 로, 없는 프레임은 녹화된 중심점을 카메라 객체로 재생한다
+// (객체 모드 녹화는 ObjectReplaySource 와 같은 경로).
+class FrameRecordingSource : public IFrameSource
+{
+public:
+    static std::unique_ptr<FrameRecordingSource> open(const std::string& path,
+                                                      ReplayPacing pacing,
+                                                      bool loop,
+                                                      std::string& errorOut);
+
+    int  width()  const override { return reader_->width(); }
+    int  height() const override { return reader_->height(); }
+    bool nextFrame(SourceFrame& out) override;
+    bool finished() const override { return finished_; }
+    bool objectMode() const override { return reader_->objectMode(); }
+
+    uint32_t frameCount() const { return reader_->frameCount(); }
+
+private:
+    FrameRecordingSource() = default;
+
+    std::unique_ptr<FrameRecordingReader> reader_;
+    std::vector<SourceObject>             objects_;    // 현재 프레임 객체 (재사용)
+
+    ReplayPacing pacing_   = ReplayPacing::Realtime;
+    bool         loop_     = false;
+    bool         finished_ = false;
+    uint32_t     next_     = 0;
+
+    std::chrono::steady_clock::time_point wallStart_;
+    uint64_t                              firstTsUs_ = 0;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+// 동시에 여는 최대 카메라 수 (setting.cfg: camera_count)
+constexpr int MAX_CAMERAS = 8;
+
+// 객체 모드 프레임 1장에 담을 최대 객체 수 (넘는 객체는 버림)
+constexpr int MAX_SOURCE_OBJECTS = 256;
+
+// ========== 카메라가 직접 분할한 객체 (객체 모드) ==========
+struct SourceObject
+{
+    float x    = 0.f;   // 무게중심 (원본 카메라 픽셀, sub-pixel)
+    float y    = 0.f;
+    int   area = 0;     // 픽셀 수
+};
+
+// ========== 프레임 소스에서 받은 1프레임 ==========
+// data / objects 는 다음 nextFrame() 호출 전까지만 유효 (소스가 소유)
+// 객체 모드 프레임은 data == nullptr 이고 objects 만 채워진다 (호스트 분할 생략).
+struct SourceFrame
+{
+    const unsigned char* data        = nullptr; // 8-bit grayscale, stride == width (객체 모드면 nullptr)
+    const SourceObject*  objects     = nullptr; // 객체 모드: 카메라가 보고한 객체 목록
+    int                  objectCount = 0;
+    int                  width       = 0;
+    int                  height      = 0;
+    uint32_t             frameId     = 0;       // 카메라/녹화 파일의 프레임 번호
+    double               timestamp   = 0.0;     // 소스 기준 타임스탬프 (초)
+};
+
+// ========== 프레임 소스 인터페이스 ==========
+// OptiTrack 카메라(OptiTrackFrameSource)와 녹화 파일 재생(ReplayFrameSource)을
+// 동일한 경로(detect → warp → send)로 처리하기 위한 추상화.
+class IFrameSource
+{
+public:
+    virtual ~IFrameSource() = default;
+
+    virtual int width()  const = 0;
+    virtual int height() const = 0;
+
+    // 새 프레임이 있으면 out 을 채우고 true 반환. 없으면 false (논블로킹 또는 페이싱 대기 후)
+    virtual bool nextFrame(SourceFrame& out) = 0;
+
+    // 재생 소스가 끝까지 도달했는지 여부 (카메라는 항상 false)
+    virtual bool finished() const { return false; }
+
+    // 런타임 노출 변경. 노출 개념이 없는 소스는 무시.
+    virtual void setExposure(int /*exposure*/) {}
+
+    // 객체 모드 소스 여부 (프레임이 보통 픽셀 없이 객체 목록만 가짐)
+    virtual bool objectMode() const { return false; }
+
+    // 객체 모드에서 표시용 grayscale 프레임 1장 요청 (어느 스레드에서나).
+    // 지원하지 않으면 false — 호출 측이 객체 목록으로 미리보기를 합성한다.
+    virtual bool requestGrayscale() { return false; }
+};
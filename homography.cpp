@@ -1,6 +1,20 @@
 #include "homography.h"
 #include <iostream>
 
+void computeHomography(HomographyState& hs, int targetWidth, int targetHeight,
+                       const LensModel& lens)
+{
+    float tw = static_cast<float>(targetWidth  - 1);
+    float th = static_cast<float>(targetHeight - 1);
+    std::vector<cv::Point2f> dstPoints = {
+        {0.f, 0.f}, {tw, 0.f}, {tw, th}, {0.f, th}
+    };
+    std::vector<cv::Point2f> srcPoints;
+    undistortPixels(lens, hs.selectedPoints, srcPoints);
+    hs.matrix = cv::getPerspectiveTransform(srcPoints, dstPoints);
+    hs.ready  = true;
+}
+
 void onMouse(int event, int x, int y, int flags, void* userdata)
 {
     if (event != cv::EVENT_LBUTTONDOWN) return;
@@ -32,13 +46,8 @@ void onMouse(int event, int x, int y, int flags, void* userdata)
         {
             std::cout << "All 4 points selected. Calculating homography..." << std::endl;
 
-            float tw = static_cast<float>(md->targetWidth  - 1);
-            float th = static_cast<float>(md->targetHeight - 1);
-            std::vector<cv::Point2f> dstPoints = {
-                {0.f, 0.f}, {tw, 0.f}, {tw, th}, {0.f, th}
-            };
-            hs->matrix = cv::getPerspectiveTransform(hs->selectedPoints, dstPoints);
-            hs->ready  = true;
+            computeHomography(*hs, md->targetWidth, md->targetHeight,
+                              md->lens ? *md->lens : LensModel());
 
             std::cout << "Homography matrix calculated. Warped view ready." << std::endl;
         }
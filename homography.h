@@ -4,6 +4,8 @@
 #include <vector>
 #include <string>
 
+#include "lens_model.h"
+
 // ========== 호모그래피 상태 ==========
 struct HomographyState
 {
@@ -29,6 +31,12 @@ struct MouseCallbackData
     int              targetWidth;
     int              targetHeight;
     HomographyState* state;    // 전역 대신 포인터로 주입
+    const LensModel* lens;     // 코너 왜곡 제거용 (nullptr = 보정 없음)
 };
 
+// selectedPoints (원본 카메라 픽셀 4점) → 타깃 사각형 호모그래피 계산 후 ready = true.
+// 렌즈 보정이 켜져 있으면 코너를 먼저 왜곡 제거 → matrix 는 "왜곡 제거 픽셀 → 타깃" 변환.
+void computeHomography(HomographyState& hs, int targetWidth, int targetHeight,
+                       const LensModel& lens);
+
 void onMouse(int event, int x, int y, int flags, void* userdata);
@@ -0,0 +1,125 @@
+/*
+ * 다점 호모그래피 자동 캘리브레이션 (카메라 불필요, 녹화 파일 사용)
+ *
+ * 타깃 평면에 투사/부착한 cols × rows IR 기준점 격자를 녹화한 파일(.irrec / .irobj / .irraw)에서, IRViewer 와 같은
+ * FrameProcessor::detect() (객체 모드 프레임은 ingestObjects()) 로 중심점을 얻어 격자 노드에 대응시키고 여러 프레임의 대응점을 모아
+ * RANSAC + 최소제곱 호모그래피를 구한다. 재투영 오차(타깃 px)를 보고하고 --write 면
+ * 4 모서리 코너를 conf/setting.cfg 에 저장 (렌즈 보정 계수가 있으면 함께 반영).
+ *
+ * 격자 크기·여백·렌즈·검출 설정은 conf/setting.cfg (fiducial_*, lens_*, centroid_* ...) 를 따르고
+ * 명령행으로 덮어쓸 수 있다. 운영자 없이 여러 베이를 일괄 재캘리브레이션할 수 있도록
+ * --max-rms 를 넘으면 종료 코드 1.
+ *
+ * 사용법:
+ *   HomographyCalibration --replay <file.irrec|file.irobj|file.irraw> [--camera N] [--cols N] [--rows N] [--margin PX]
+ *                         [--ransac PX] [--frames N] [--max-rms PX] [--write]
+ *
+ *   --camera : 다중 카메라 설정에서 코너를 저장할 카메라 번호 (1부터, 기본 1)
+ */
+
+#include "config_manager.h"
+#include "fiducial_calibration.h"
+#include "frame_processor.h"
+#include "frame_recorder.h"
+#include "homography.h"
+#include "settings.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    AppSettings       settings;
+    CameraCorners     corners;
+    CameraBackgrounds backgrounds;
+    loadConfig(settings, corners, backgrounds);      // 없으면 기본값
+
+    std::string replayPath;
+    int         camera    = 0;
+    int         maxFrames = 60;
+    double      maxRms    = 0.0;        // 0 = 검사 안 함
+    bool        write     = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if      (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)  replayPath = argv[++i];
+        else if (strcmp(argv[i], "--camera") == 0 && i + 1 < argc)  camera     = std::max(0, std::min(MAX_CAMERAS, atoi(argv[++i])) - 1);
+        else if (strcmp(argv[i], "--cols") == 0 && i + 1 < argc)    settings.fiducial.cols     = std::max(2, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc)    settings.fiducial.rows     = std::max(2, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--margin") == 0 && i + 1 < argc)  settings.fiducial.marginPx = static_cast<float>(atof(argv[++i]));
+        else if (strcmp(argv[i], "--ransac") == 0 && i + 1 < argc)  settings.fiducial.ransacPx = static_cast<float>(atof(argv[++i]));
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)  maxFrames = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--max-rms") == 0 && i + 1 < argc) maxRms    = atof(argv[++i]);
+        else if (strcmp(argv[i], "--write") == 0)                    write     = true;
+    }
+    if (replayPath.empty())
+    {
+        fprintf(stderr, "Usage: HomographyCalibration --replay <file.irrec|file.irobj|file.irraw> [--camera N] [--cols N] [--rows N] "
+                        "[--margin PX] [--ransac PX] [--frames N] [--max-rms PX] [--write]\n");
+        return 2;
+    }
+
+    std::string error;
+    auto source = openRecording(replayPath, ReplayPacing::AsFastAsPossible, false, error);
+    if (!source)
+    {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    printf("Fiducial grid %dx%d, margin %.1f px, target %dx%d, lens undistort %s\n",
+           settings.fiducial.cols, settings.fiducial.rows, settings.fiducial.marginPx,
+           settings.targetWidth, settings.targetHeight, settings.lens.active() ? "on" : "off");
+
+    // 호모그래피 없는 상태 = 전체 프레임 검출 (IRViewer 의 코너 선택 전과 같음)
+    HomographyState    noHom;
+    FrameProcessor     processor;
+    FiducialCalibrator calibrator(settings.fiducial, settings.targetWidth, settings.targetHeight,
+                                  settings.lens);
+    SourceFrame frame;
+    long        scanned = 0;
+    while (calibrator.matchedFrames() < maxFrames && !source->finished())
+    {
+        if (!source->nextFrame(frame)) continue;
+        ++scanned;
+        const FrameResult& r = frame.data
+            ? processor.detect(frame.data, frame.width, frame.height, noHom, settings)
+            : processor.ingestObjects(frame.objects, frame.objectCount, frame.width, frame.height, noHom, settings);
+        calibrator.addFrame(r.detectedCenters);
+    }
+
+    FiducialFitResult fit = calibrator.solve();
+    printf("Scanned %ld frame(s), %d matched, %d correspondence(s)\n",
+           scanned, fit.frames, fit.correspondences);
+    if (!fit.ok)
+    {
+        fprintf(stderr, "Calibration failed: %s\n", fit.error.c_str());
+        return 1;
+    }
+
+    printf("Inliers %d / %d, reprojection RMS %.3f px, max %.3f px (target plane)\n",
+           fit.inliers, fit.correspondences, fit.rmsPx, fit.maxPx);
+    for (size_t i = 0; i < fit.corners.size(); i++)
+        printf("  corner%zu = (%.2f, %.2f)\n", i, fit.corners[i].x, fit.corners[i].y);
+
+    bool ok = maxRms <= 0.0 || fit.rmsPx <= maxRms;
+    if (!ok)
+        printf("FAIL: RMS %.3f px > limit %.3f px\n", fit.rmsPx, maxRms);
+
+    if (write && ok)
+    {
+        // 다른 카메라 코너는 그대로 두고 이 카메라 것만 교체
+        if (static_cast<int>(corners.size()) <= camera) corners.resize(camera + 1);
+        corners[camera] = fit.corners;
+        if (!saveConfig(settings, corners, backgrounds)) return 1;
+        printf("Saved camera %d corners to %sconf/setting.cfg\n", camera + 1, getExeDir().c_str());
+    }
+    else if (!write)
+    {
+        printf("Dry run. Pass --write to store the corners in conf/setting.cfg.\n");
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// ========== 지연 히스토그램 (µs, 로그 버킷) ==========
+// 2의 거듭제곱 구간마다 4개의 선형 하위 버킷 → 상대 오차 ≤ 25%, 1 µs ~ 약 1시간 범위.
+// record() 는 한 스레드(기록자)에서만, 나머지 조회는 어느 스레드에서든 호출 가능 (근사 스냅샷).
+class LatencyHistogram
+{
+public:
+    static constexpr int SUB_BUCKETS = 4;
+    static constexpr int BUCKETS     = 4 + 32 * SUB_BUCKETS;
+
+    void record(uint64_t us)
+    {
+        buckets_[bucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(us, std::memory_order_relaxed);
+        if (us > max_.load(std::memory_order_relaxed))
+            max_.store(us, std::memory_order_relaxed);
+    }
+
+    uint64_t count()   const { return count_.load(std::memory_order_relaxed); }
+    uint64_t maxUs()   const { return max_.load(std::memory_order_relaxed); }
+    double   meanUs()  const
+    {
+        uint64_t n = count();
+        return n ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+
+    uint64_t bucketCount(int i) const { return buckets_[i].load(std::memory_order_relaxed); }
+
+    // p (0~1) 분위수가 속한 버킷의 상한 (µs). 기록이 없으면 0.
+    uint64_t percentileUs(double p) const
+    {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p * (n - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++)
+        {
+            seen += bucketCount(i);
+            if (seen >= rank) return bucketUpper(i);
+        }
+        return maxUs();
+    }
+
+    // 비어 있지 않은 버킷만 "[lo, hi) µs  count" 형식으로 출력 (종료 로그용)
+    void print(std::ostream& os, const char* title) const
+    {
+        os << title << ": n=" << count() << " mean=" << meanUs() << "us"
+           << " p50=" << percentileUs(0.50) << "us p95=" << percentileUs(0.95) << "us"
+           << " p99=" << percentileUs(0.99) << "us"
+           << " max=" << maxUs() << "us" << std::endl;
+        for (int i = 0; i < BUCKETS; i++)
+        {
+            uint64_t c = buckets_[i].load(std::memory_order_relaxed);
+            if (c == 0) continue;
+            os << "  [" << bucketLower(i) << ", " << bucketUpper(i) << ") us  " << c << std::endl;
+        }
+    }
+
+    void reset()
+    {
+        for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    static uint64_t bucketLower(int i)
+    {
+        if (i < 4) return static_cast<uint64_t>(i);
+        int msb = (i - 4) / SUB_BUCKETS + 2;
+        int sub = (i - 4) % SUB_BUCKETS;
+        return (static_cast<uint64_t>(4 + sub)) << (msb - 2);
+    }
+
+    static uint64_t bucketUpper(int i) { return bucketLower(i + 1); }
+
+private:
+    // 0~3 µs 는 1 µs 단위, 그 이상은 [2^k, 2^(k+1)) 를 4등분
+    static int bucketIndex(uint64_t us)
+    {
+        if (us < 4) return static_cast<int>(us);
+        int msb = 63;
+        while ((us >> msb) == 0) msb--;
+        int sub = static_cast<int>((us >> (msb - 2)) & 3);
+        int idx = 4 + (msb - 2) * SUB_BUCKETS + sub;
+        return idx < BUCKETS ? idx : BUCKETS - 1;
+    }
+
+    std::atomic<uint64_t> buckets_[BUCKETS] = {};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// ========== 최근 구간 분위수 (rolling) ==========
+// 누적 히스토그램을 주기적으로 roll() 해 직전 스냅샷과의 차이로 최근 구간의 분포를 구한다.
+// 기록자와 락을 공유하지 않으며 조회 스레드 하나에서만 사용.
+class LatencyWindow
+{
+public:
+    void roll(const LatencyHistogram& h)
+    {
+        count_ = 0;
+        for (int i = 0; i < LatencyHistogram::BUCKETS; i++)
+        {
+            uint64_t c = h.bucketCount(i);
+            window_[i] = c - last_[i];
+            last_[i]   = c;
+            count_    += window_[i];
+        }
+    }
+
+    uint64_t count() const { return count_; }
+
+    // 직전 구간의 p (0~1) 분위수 (버킷 상한, µs). 구간에 기록이 없으면 0.
+    uint64_t percentileUs(double p) const
+    {
+        if (count_ == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p * (count_ - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < LatencyHistogram::BUCKETS; i++)
+        {
+            seen += window_[i];
+            if (seen >= rank) return LatencyHistogram::bucketUpper(i);
+        }
+        return 0;
+    }
+
+private:
+    uint64_t last_[LatencyHistogram::BUCKETS]   = {};
+    uint64_t window_[LatencyHistogram::BUCKETS] = {};
+    uint64_t count_ = 0;
+};
@@ -0,0 +1,68 @@
+#include "latency_trace.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+const char* LatencyTrace::stageName(Stage s)
+{
+    switch (s)
+    {
+    case Detect:  return "acquire_to_detect";
+    case Handoff: return "detect_to_handoff";
+    case Send:    return "handoff_to_sendto";
+    case Total:   return "acquire_to_sendto";
+    default:      break;
+    }
+    return "unknown";
+}
+
+// 음수(시계 역전/미기록)는 0 으로
+static uint64_t elapsedUs(int64_t from, int64_t to)
+{
+    return static_cast<uint64_t>(std::max<int64_t>(0, to - from)) / 1000;
+}
+
+void LatencyTrace::record(const FrameTimestamps& t, int64_t handoffNs, int64_t sentNs)
+{
+    hist_[Send].record(elapsedUs(handoffNs, sentNs));
+
+    // 프레임 시각이 없으면 (파이프라인 밖에서 updatePoints 호출) 전송 구간만 기록
+    if (t.acquireNs == 0 || t.detectNs == 0) return;
+    hist_[Detect].record(elapsedUs(t.acquireNs, t.detectNs));
+    hist_[Handoff].record(elapsedUs(t.detectNs, handoffNs));
+    hist_[Total].record(elapsedUs(t.acquireNs, sentNs));
+}
+
+void LatencyTrace::roll()
+{
+    for (int s = 0; s < STAGE_COUNT; s++) window_[s].roll(hist_[s]);
+}
+
+void LatencyTrace::print(std::ostream& os) const
+{
+    for (int s = 0; s < STAGE_COUNT; s++)
+    {
+        std::string title = std::string("[Latency] ") + stageName(static_cast<Stage>(s));
+        hist_[s].print(os, title.c_str());
+    }
+}
+
+bool LatencyTrace::writeCsv(const std::string& path) const
+{
+    std::ofstream ofs(path);
+    if (!ofs.is_open())
+    {
+        std::cerr << "[Latency] Cannot write " << path << std::endl;
+        return false;
+    }
+    ofs << "stage,count,mean_us,p50_us,p95_us,p99_us,max_us\n";
+    for (int s = 0; s < STAGE_COUNT; s++)
+    {
+        const LatencyHistogram& h = hist_[s];
+        ofs << stageName(static_cast<Stage>(s)) << ',' << h.count() << ','
+            << static_cast<uint64_t>(h.meanUs()) << ',' << h.percentileUs(0.50) << ','
+            << h.percentileUs(0.95) << ',' << h.percentileUs(0.99) << ',' << h.maxUs() << '\n';
+    }
+    std::cout << "[Latency] Summary written to " << path << std::endl;
+    return true;
+}
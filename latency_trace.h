@@ -0,0 +1,60 @@
+#pragma once
+
+#include "latency_histogram.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// steady_clock 현재 시각 (ns) — 스레드 사이 단계별 시각 비교용
+inline int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ========== 프레임 단계별 시각 (steady_clock ns, 0 = 기록 없음) ==========
+struct FrameTimestamps
+{
+    int64_t acquireNs = 0;      // 캡처 스레드가 소스에서 프레임을 받은 시각
+    int64_t detectNs  = 0;      // 처리 스레드의 detect() 완료 시각
+};
+
+// ========== 종단 간 지연 추적 (acquire → detect → 전송 스레드 전달 → sendto) ==========
+// 전송 스레드가 새 좌표를 처음 보낼 때 그 좌표의 단계별 시각으로 모든 단계를 기록한다.
+// (기록자는 전송 스레드 하나 → 네 단계가 같은 프레임 집합을 설명하므로 단계 합 ≈ total)
+// acquire 는 호스트가 프레임을 받은 시각 — 노출~USB 전송 구간은 카메라 시계라 포함되지 않는다.
+class LatencyTrace
+{
+public:
+    enum Stage
+    {
+        Detect  = 0,    // acquire → detect 완료
+        Handoff = 1,    // detect 완료 → updatePoints (전송 스레드로 전달)
+        Send    = 2,    // updatePoints → sendto 완료
+        Total   = 3,    // acquire → sendto 완료
+        STAGE_COUNT
+    };
+
+    static const char* stageName(Stage s);
+
+    // 전송 스레드 전용
+    void record(const FrameTimestamps& t, int64_t handoffNs, int64_t sentNs);
+
+    const LatencyHistogram& histogram(Stage s) const { return hist_[s]; }
+
+    // 조회 스레드 전용: 직전 roll() 이후 구간으로 rolling 분위수 갱신 (OSD 는 1초마다)
+    void roll();
+    const LatencyWindow& window(Stage s) const { return window_[s]; }
+
+    // 누적 분포를 로그로 출력
+    void print(std::ostream& os) const;
+
+    // 단계별 요약 "stage,count,mean_us,p50_us,p95_us,p99_us,max_us" CSV. 실패 시 false.
+    bool writeCsv(const std::string& path) const;
+
+private:
+    LatencyHistogram hist_[STAGE_COUNT];
+    LatencyWindow    window_[STAGE_COUNT];
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+
+// ========== 최신 값 전달 채널 (triple buffer, lock-free) ==========
+// 생산자 스레드 하나가 값을 계속 덮어쓰고, 소비자 스레드 하나가 "가장 최근 값"만 읽는 용도.
+// 버퍼 3개를 돌려 쓰므로 양쪽 모두 블로킹하지 않고, 값 복사 외의 할당도 없다.
+//
+//   생산자: T& w = ch.writeBuffer();  ...w 채우기...;  ch.publish();
+//   소비자: ch.update();  const T& r = ch.read();   // update() 가 false 면 이전 값 그대로
+//
+// T 는 고정 크기여야 의미가 있다 (std::vector 처럼 힙을 가리키면 할당 문제가 그대로 남음).
+template <typename T>
+class LatestValue
+{
+public:
+    // ----- 생산자 전용 -----
+    T& writeBuffer() { return slots_[writeIndex_].value; }
+
+    // writeBuffer() 내용을 게시하고, 소비자가 놓아 준 버퍼를 다음 쓰기용으로 받음
+    void publish()
+    {
+        int prev    = middle_.exchange(writeIndex_ | DIRTY, std::memory_order_acq_rel);
+        writeIndex_ = prev & INDEX_MASK;
+    }
+
+    // ----- 소비자 전용 -----
+    // 새 값이 게시됐으면 읽기 버퍼를 교체하고 true
+    bool update()
+    {
+        if ((middle_.load(std::memory_order_relaxed) & DIRTY) == 0) return false;
+        int prev   = middle_.exchange(readIndex_, std::memory_order_acq_rel);
+        readIndex_ = prev & INDEX_MASK;
+        return true;
+    }
+
+    const T& read() const { return slots_[readIndex_].value; }
+
+private:
+    static constexpr int DIRTY      = 4;   // middle_ 에 새 값이 있음
+    static constexpr int INDEX_MASK = 3;
+
+    // 버퍼마다 캐시 라인을 분리해 생산자/소비자 간 false sharing 방지
+    struct alignas(64) Slot { T value{}; };
+
+    Slot             slots_[3];
+    std::atomic<int> middle_{1};            // 생산자와 소비자 사이에서 교환되는 버퍼
+    alignas(64) int  writeIndex_ = 0;       // 생산자만 접근
+    alignas(64) int  readIndex_  = 2;       // 소비자만 접근
+};
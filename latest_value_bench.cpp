@@ -0,0 +1,206 @@
+/*
+ * UDPSender 좌표 전달 경로 마이크로벤치마크 (OpenCV / Winsock 불필요)
+ *
+ * 기존 경로(std::mutex + std::vector 복사)와 LatestValue<PointBatch> (triple buffer) 를
+ * 실제 운용 조건과 같은 주기로 비교한다:
+ *   - 생산자(처리 스레드): 240 Hz 로 좌표 갱신
+ *   - 소비자(전송 스레드): 1000 Hz 로 최신 좌표 읽기
+ *
+ * 호출 1회당 소요 시간(p50/p99/max)과 호출당 힙 할당 수를 출력한다.
+ *
+ * 사용법:
+ *   LatestValueBench.exe [--seconds N] [--points N]
+ */
+
+#include "latest_value.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+// ========== 전역 할당 카운터 ==========
+static std::atomic<long> g_allocations{0};
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// cv::Point2f 와 같은 배치 (벤치마크는 OpenCV 없이 빌드)
+struct Point { float x, y; };
+
+struct Batch
+{
+    static constexpr int MAX_POINTS = 64;
+    int   count = 0;
+    Point points[MAX_POINTS];
+};
+
+using Clock = std::chrono::steady_clock;
+
+// ========== 비교 대상 1: 기존 mutex + vector 경로 ==========
+class MutexChannel
+{
+public:
+    void update(const std::vector<Point>& pts)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        points_ = pts;
+    }
+
+    // 기존 sendLoop() 와 동일: 매 tick 지역 벡터로 복사
+    int read()
+    {
+        std::vector<Point> pts;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pts = points_;
+        }
+        return static_cast<int>(pts.size());
+    }
+
+private:
+    std::mutex         mutex_;
+    std::vector<Point> points_;
+};
+
+// ========== 비교 대상 2: triple buffer ==========
+class TripleBufferChannel
+{
+public:
+    void update(const std::vector<Point>& pts)
+    {
+        Batch& b = latest_.writeBuffer();
+        int n = std::min(static_cast<int>(pts.size()), Batch::MAX_POINTS);
+        std::copy(pts.begin(), pts.begin() + n, b.points);
+        b.count = n;
+        latest_.publish();
+    }
+
+    int read()
+    {
+        latest_.update();
+        return latest_.read().count;
+    }
+
+private:
+    LatestValue<Batch> latest_;
+};
+
+// ========== 측정 ==========
+struct StageResult
+{
+    std::vector<long> ns;       // 호출별 소요 시간
+    long              allocs = 0;
+};
+
+static long percentile(std::vector<long>& v, double p)
+{
+    if (v.empty()) return 0;
+    size_t k = static_cast<size_t>(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+static void printStage(const char* name, StageResult& r)
+{
+    long maxNs = r.ns.empty() ? 0 : *std::max_element(r.ns.begin(), r.ns.end());
+    size_t calls = r.ns.size();
+    long p50 = percentile(r.ns, 0.50);
+    long p99 = percentile(r.ns, 0.99);
+    printf("  %-8s calls=%-7zu p50=%6ld ns  p99=%6ld ns  max=%8ld ns  allocs/call=%.2f\n",
+           name, calls, p50, p99, maxNs,
+           calls ? static_cast<double>(r.allocs) / calls : 0.0);
+}
+
+template <typename Channel>
+static void runScenario(const char* title, double seconds, int pointCount)
+{
+    Channel channel;
+    StageResult prod, cons;
+    prod.ns.reserve(static_cast<size_t>(seconds * 240) + 16);
+    cons.ns.reserve(static_cast<size_t>(seconds * 1000) + 16);
+
+    std::vector<Point> pts(pointCount);
+    std::atomic<bool> stop{false};
+    long checksum = 0;
+
+    auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                  std::chrono::duration<double>(seconds));
+
+    // 생산자 240 Hz
+    std::thread producer([&]
+    {
+        auto next = Clock::now();
+        const auto period = std::chrono::microseconds(1000000 / 240);
+        float t = 0.f;
+        while (Clock::now() < end)
+        {
+            for (int i = 0; i < pointCount; i++) pts[i] = { t + i, t - i };
+            t += 1.f;
+
+            long a0 = g_allocations.load(std::memory_order_relaxed);
+            auto t0 = Clock::now();
+            channel.update(pts);
+            auto t1 = Clock::now();
+            prod.allocs += g_allocations.load(std::memory_order_relaxed) - a0;
+            prod.ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+        stop.store(true);
+    });
+
+    // 소비자 1000 Hz (현재 스레드)
+    {
+        auto next = Clock::now();
+        const auto period = std::chrono::microseconds(1000);
+        while (!stop.load())
+        {
+            long a0 = g_allocations.load(std::memory_order_relaxed);
+            auto t0 = Clock::now();
+            checksum += channel.read();
+            auto t1 = Clock::now();
+            cons.allocs += g_allocations.load(std::memory_order_relaxed) - a0;
+            cons.ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+    }
+    producer.join();
+
+    // 할당 카운터는 전역이므로 다른 스레드의 할당이 섞일 수 있음 (측정 벡터는 미리 reserve)
+    printf("%s  (checksum %ld)\n", title, checksum);
+    printStage("update", prod);
+    printStage("read", cons);
+}
+
+int main(int argc, char* argv[])
+{
+    double seconds    = 3.0;
+    int    pointCount = 8;
+    for (int i = 1; i < argc; i++)
+    {
+        if      (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds    = atof(argv[++i]);
+        else if (strcmp(argv[i], "--points")  == 0 && i + 1 < argc) pointCount = atoi(argv[++i]);
+    }
+    pointCount = std::max(1, std::min(pointCount, Batch::MAX_POINTS));
+
+    printf("Update 240 Hz / read 1000 Hz, %d point(s), %.1f s per path\n\n", pointCount, seconds);
+    runScenario<MutexChannel>("[mutex + vector]", seconds, pointCount);
+    runScenario<TripleBufferChannel>("[triple buffer]", seconds, pointCount);
+    return 0;
+}
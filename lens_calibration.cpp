@@ -0,0 +1,246 @@
+/*
+ * 렌즈 왜곡 캘리브레이션 (카메라 불필요, 녹화 파일 사용)
+ *
+ * 녹화 파일(V 키 / --record 의 .irrec, 또는 .irraw)에서 체커보드 또는 IR 점 격자를 찾아 cv::calibrateCamera 로
+ * 카메라 행렬 + 왜곡 계수(k1, k2, p1, p2, k3)를 추정하고, --write 면 conf/setting.cfg 의
+ * lens_* 키에 저장한다 (기존 설정·코너는 유지, lens_undistort=1).
+ *
+ * 런타임(IRViewer)은 이 계수로 검출 중심점만 왜곡 제거한 뒤 호모그래피를 적용한다.
+ * 코너는 원본 픽셀로 저장되어 있으므로 다시 찍을 필요 없음 (시작 시 왜곡 제거 후 호모그래피 재계산).
+ *
+ * 녹화 팁: 패턴을 화면 가장자리·모서리까지 고루, 여러 기울기로 움직이며 녹화.
+ *
+ * 사용법:
+ *   LensCalibration --replay <file.irrec|file.irraw> [--replay <file2> ...]
+ *                   [--pattern chessboard|circles|acircles] [--cols N] [--rows N]
+ *                   [--step N] [--max-views N] [--min-move PX] [--write]
+ *
+ *   --replay        : 픽셀 없는 프레임(카메라 객체 모드 녹화, .irobj)은 건너뜀
+ *   --cols / --rows : 체커보드 내부 코너 수 또는 점 격자의 열/행 수 (기본 9×6)
+ *   --step          : N 프레임마다 하나만 검사 (기본 5)
+ *   --max-views     : 캘리브레이션에 쓸 최대 뷰 수 (기본 40)
+ *   --min-move      : 직전 채택 뷰와 평균 코너 이동이 이 값(px) 미만이면 중복으로 보고 버림 (기본 20)
+ */
+
+#include "config_manager.h"
+#include "frame_recorder.h"
+#include "settings.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+enum class CalibPattern
+{
+    Chessboard,
+    Circles,            // 대칭 점 격자 (밝은 IR 점)
+    AsymmetricCircles
+};
+
+struct CalibOptions
+{
+    std::vector<std::string> replayPaths;
+    CalibPattern pattern  = CalibPattern::Chessboard;
+    int          cols     = 9;
+    int          rows     = 6;
+    int          step     = 5;
+    int          maxViews = 40;
+    double       minMove  = 20.0;
+    bool         write    = false;
+};
+
+static bool parsePattern(const char* s, CalibPattern& out)
+{
+    if (strcmp(s, "chessboard") == 0) { out = CalibPattern::Chessboard;        return true; }
+    if (strcmp(s, "circles") == 0)    { out = CalibPattern::Circles;           return true; }
+    if (strcmp(s, "acircles") == 0)   { out = CalibPattern::AsymmetricCircles; return true; }
+    return false;
+}
+
+// 패턴 좌표 (단위 = 격자 간격 1). 평면이므로 z = 0. 초점 거리/왜곡은 간격 단위와 무관.
+static std::vector<cv::Point3f> patternPoints(const CalibOptions& opt)
+{
+    std::vector<cv::Point3f> pts;
+    for (int r = 0; r < opt.rows; r++)
+    {
+        for (int c = 0; c < opt.cols; c++)
+        {
+            if (opt.pattern == CalibPattern::AsymmetricCircles)
+                pts.emplace_back(static_cast<float>(2 * c + r % 2), static_cast<float>(r), 0.f);
+            else
+                pts.emplace_back(static_cast<float>(c), static_cast<float>(r), 0.f);
+        }
+    }
+    return pts;
+}
+
+static bool findPattern(const cv::Mat& gray, const CalibOptions& opt,
+                        const cv::Ptr<cv::FeatureDetector>& blobDetector,
+                        std::vector<cv::Point2f>& corners)
+{
+    cv::Size size(opt.cols, opt.rows);
+    if (opt.pattern == CalibPattern::Chessboard)
+    {
+        if (!cv::findChessboardCorners(gray, size, corners,
+                                       cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE |
+                                       cv::CALIB_CB_FAST_CHECK))
+            return false;
+        cv::cornerSubPix(gray, corners, cv::Size(5, 5), cv::Size(-1, -1),
+                         cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.01));
+        return true;
+    }
+    int flags = opt.pattern == CalibPattern::Circles ? cv::CALIB_CB_SYMMETRIC_GRID
+                                                     : cv::CALIB_CB_ASYMMETRIC_GRID;
+    return cv::findCirclesGrid(gray, size, corners, flags, blobDetector);
+}
+
+static double meanMove(const std::vector<cv::Point2f>& a, const std::vector<cv::Point2f>& b)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); i++) sum += cv::norm(a[i] - b[i]);
+    return a.empty() ? 0.0 : sum / a.size();
+}
+
+int main(int argc, char* argv[])
+{
+    CalibOptions opt;
+    for (int i = 1; i < argc; i++)
+    {
+        if      (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)    opt.replayPaths.push_back(argv[++i]);
+        else if (strcmp(argv[i], "--cols") == 0 && i + 1 < argc)      opt.cols     = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc)      opt.rows     = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--step") == 0 && i + 1 < argc)      opt.step     = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--max-views") == 0 && i + 1 < argc) opt.maxViews = std::max(3, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--min-move") == 0 && i + 1 < argc)  opt.minMove  = atof(argv[++i]);
+        else if (strcmp(argv[i], "--write") == 0)                      opt.write    = true;
+        else if (strcmp(argv[i], "--pattern") == 0 && i + 1 < argc)
+        {
+            if (!parsePattern(argv[++i], opt.pattern))
+            {
+                fprintf(stderr, "Unknown pattern: %s\n", argv[i]);
+                return 2;
+            }
+        }
+    }
+    if (opt.replayPaths.empty() || opt.cols < 2 || opt.rows < 2)
+    {
+        fprintf(stderr, "Usage: LensCalibration --replay <file.irrec|file.irraw> [--pattern chessboard|circles|acircles] "
+                        "[--cols N] [--rows N] [--step N] [--max-views N] [--min-move PX] [--write]\n");
+        return 2;
+    }
+
+    // IR 점 격자는 어두운 배경의 밝은 점 → 기본(어두운 블롭) 대신 밝은 블롭 검출기
+    cv::SimpleBlobDetector::Params blobParams;
+    blobParams.filterByColor = true;
+    blobParams.blobColor     = 255;
+    blobParams.minArea       = 4.f;
+    cv::Ptr<cv::FeatureDetector> blobDetector = cv::SimpleBlobDetector::create(blobParams);
+
+    std::vector<cv::Point3f>              objectTemplate = patternPoints(opt);
+    std::vector<std::vector<cv::Point3f>> objectPoints;
+    std::vector<std::vector<cv::Point2f>> imagePoints;
+    cv::Size imageSize;
+    long     scanned = 0;
+
+    for (const std::string& path : opt.replayPaths)
+    {
+        std::string error;
+        auto source = openRecording(path, ReplayPacing::AsFastAsPossible, false, error);
+        if (!source)
+        {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        if (imageSize.area() == 0)
+            imageSize = cv::Size(source->width(), source->height());
+        else if (imageSize != cv::Size(source->width(), source->height()))
+        {
+            fprintf(stderr, "%s: resolution %dx%d differs from first recording %dx%d\n", path.c_str(),
+                    source->width(), source->height(), imageSize.width, imageSize.height);
+            return 1;
+        }
+
+        SourceFrame frame;
+        long index = 0;
+        while (static_cast<int>(imagePoints.size()) < opt.maxViews && !source->finished())
+        {
+            if (!source->nextFrame(frame) || !frame.data) continue;
+            if (index++ % opt.step != 0) continue;
+            ++scanned;
+
+            cv::Mat gray(frame.height, frame.width, CV_8UC1, const_cast<unsigned char*>(frame.data));
+            std::vector<cv::Point2f> corners;
+            if (!findPattern(gray, opt, blobDetector, corners)) continue;
+            if (!imagePoints.empty() && meanMove(corners, imagePoints.back()) < opt.minMove) continue;
+
+            imagePoints.push_back(corners);
+            objectPoints.push_back(objectTemplate);
+            printf("  view %2zu: %s frame %u\n", imagePoints.size(), path.c_str(), frame.frameId);
+        }
+    }
+
+    printf("Scanned %ld frame(s), %zu view(s) with a %dx%d pattern\n",
+           scanned, imagePoints.size(), opt.cols, opt.rows);
+    if (imagePoints.size() < 5)
+    {
+        fprintf(stderr, "Need at least 5 distinct views; record the pattern across more of the image.\n");
+        return 1;
+    }
+
+    cv::Mat cameraMatrix, distCoeffs;
+    std::vector<cv::Mat> rvecs, tvecs;
+    double rms = cv::calibrateCamera(objectPoints, imagePoints, imageSize, cameraMatrix, distCoeffs,
+                                     rvecs, tvecs);
+
+    // 뷰별 재투영 오차 (이상치 뷰 확인용)
+    double worst = 0.0;
+    for (size_t v = 0; v < imagePoints.size(); v++)
+    {
+        std::vector<cv::Point2f> projected;
+        cv::projectPoints(objectPoints[v], rvecs[v], tvecs[v], cameraMatrix, distCoeffs, projected);
+        double err = std::sqrt(cv::norm(imagePoints[v], projected, cv::NORM_L2SQR) / projected.size());
+        worst = std::max(worst, err);
+    }
+
+    LensModel lens;
+    lens.enabled = true;
+    lens.fx = cameraMatrix.at<double>(0, 0);
+    lens.fy = cameraMatrix.at<double>(1, 1);
+    lens.cx = cameraMatrix.at<double>(0, 2);
+    lens.cy = cameraMatrix.at<double>(1, 2);
+    lens.k1 = distCoeffs.at<double>(0);
+    lens.k2 = distCoeffs.at<double>(1);
+    lens.p1 = distCoeffs.at<double>(2);
+    lens.p2 = distCoeffs.at<double>(3);
+    lens.k3 = distCoeffs.total() > 4 ? distCoeffs.at<double>(4) : 0.0;
+
+    printf("\nRMS reprojection error: %.3f px (worst view %.3f px)\n", rms, worst);
+    printf("  fx=%.3f fy=%.3f cx=%.3f cy=%.3f\n", lens.fx, lens.fy, lens.cx, lens.cy);
+    printf("  k1=%.6f k2=%.6f p1=%.6f p2=%.6f k3=%.6f\n", lens.k1, lens.k2, lens.p1, lens.p2, lens.k3);
+
+    // 이미지 모서리의 보정량 (왜곡 크기 감 잡기용)
+    cv::Point2f corner(0.f, 0.f);
+    cv::Point2f fixed = undistortPixel(lens, corner);
+    printf("  corner (0,0) moves %.1f px after undistortion\n", cv::norm(fixed - corner));
+
+    if (!opt.write)
+    {
+        printf("\nDry run. Pass --write to store lens_* in conf/setting.cfg.\n");
+        return 0;
+    }
+
+    AppSettings       settings;
+    CameraCorners     corners;
+    CameraBackgrounds backgrounds;
+    loadConfig(settings, corners, backgrounds);      // 없으면 기본값 + 코너 없음
+    settings.lens = lens;
+    if (!saveConfig(settings, corners, backgrounds)) return 1;
+    printf("\nSaved lens_* to %sconf/setting.cfg (lens_undistort=1)\n", getExeDir().c_str());
+    return 0;
+}
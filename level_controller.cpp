@@ -0,0 +1,107 @@
+#include "level_controller.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+void LevelController::configure(const LevelParams& params, int exposure)
+{
+    if (configured_ && params == params_ && exposure == baseExposure_) return;
+
+    configured_   = true;
+    params_       = params;
+    baseExposure_ = exposure;
+    peaks_.reserve(MAX_PEAK_BLOBS);
+
+    threshold_           = std::max(1, std::min(254, params.threshold));
+    exposure_            = std::max(params.exposureMin, std::min(params.exposureMax, exposure));
+    background_          = 0;
+    peak_                = 0;
+    framesSinceExposure_ = 0;
+}
+
+bool LevelController::update(const uint8_t* gray, int width, int height, const cv::Rect& roi,
+                             const std::vector<Blob>& blobs, int& exposureOut)
+{
+    if (!params_.autoThreshold && !params_.autoExposure) return false;
+
+    // ---- 1) 표본 히스토그램 → 배경 분위수 ----
+    cv::Rect area = roi & cv::Rect(0, 0, width, height);
+    if (area.empty()) return false;
+
+    int step = std::max(1, params_.sampleStep);
+    memset(hist_, 0, sizeof(hist_));
+    uint32_t total = 0;
+    for (int y = area.y; y < area.y + area.height; y += step)
+    {
+        const uint8_t* row = gray + static_cast<size_t>(y) * width;
+        for (int x = area.x; x < area.x + area.width; x += step)
+            ++hist_[row[x]];
+    }
+    for (uint32_t c : hist_) total += c;
+
+    uint32_t rank = static_cast<uint32_t>(total * (params_.backgroundPercentile / 100.0));
+    uint32_t cum  = 0;
+    background_   = 255;
+    for (int v = 0; v < 256; v++)
+    {
+        cum += hist_[v];
+        if (cum > rank)
+        {
+            background_ = v;
+            break;
+        }
+    }
+
+    // ---- 2) 블롭별 최대 밝기 → 점 밝기 (상위 25%) ----
+    peaks_.clear();
+    for (const Blob& b : blobs)
+    {
+        if (static_cast<int>(peaks_.size()) == MAX_PEAK_BLOBS) break;
+        int x0 = std::max(0, b.x0), x1 = std::min(width - 1, b.x1);
+        int y0 = std::max(0, b.y0), y1 = std::min(height - 1, b.y1);
+        int peak = 0;
+        for (int y = y0; y <= y1; y++)
+        {
+            const uint8_t* row = gray + static_cast<size_t>(y) * width;
+            for (int x = x0; x <= x1; x++) peak = std::max(peak, static_cast<int>(row[x]));
+        }
+        peaks_.push_back(peak);
+    }
+    peak_ = 0;
+    if (!peaks_.empty())
+    {
+        auto q = peaks_.begin() + (peaks_.size() * 3) / 4;
+        std::nth_element(peaks_.begin(), q, peaks_.end());
+        peak_ = *q;
+    }
+
+    // ---- 3) 임계값 (히스테리시스) ----
+    if (params_.autoThreshold)
+    {
+        int candidate = background_ + params_.minContrast;
+        if (peak_ > candidate)
+            candidate = std::max(candidate, static_cast<int>(std::lround(
+                background_ + (peak_ - background_) * params_.thresholdRatio)));
+        candidate = std::max(params_.thresholdMin, std::min(params_.thresholdMax, candidate));
+        candidate = std::max(1, std::min(254, candidate));
+        if (std::abs(candidate - threshold_) >= params_.hysteresis)
+            threshold_ = candidate;
+    }
+
+    // ---- 4) 노출 (점이 보일 때만, 반영 대기 후 한 단계씩) ----
+    if (!params_.autoExposure || peaks_.empty()) return false;
+    if (++framesSinceExposure_ < params_.exposureInterval) return false;
+
+    int next = exposure_;
+    if (peak_ >= 255 || peak_ > params_.targetPeak + params_.peakBand)
+        next = static_cast<int>(exposure_ * (1.f - params_.exposureStep));
+    else if (peak_ < params_.targetPeak - params_.peakBand)
+        next = static_cast<int>(std::ceil(exposure_ * (1.f + params_.exposureStep)));
+    next = std::max(params_.exposureMin, std::min(params_.exposureMax, next));
+    if (next == exposure_) return false;
+
+    exposure_            = next;
+    framesSinceExposure_ = 0;
+    exposureOut          = next;
+    return true;
+}
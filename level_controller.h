@@ -0,0 +1,85 @@
+#pragma once
+
+#include "blob_labeler.h"
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+// ========== 이진화 임계값 / 노출 자동 조절 설정 ==========
+// setting.cfg: threshold, auto_threshold, threshold_*, auto_exposure, exposure_*, level_sample_step
+struct LevelParams
+{
+    int   threshold            = 200;   // 고정 임계값 (auto_threshold=1 이면 시작값)
+    bool  autoThreshold        = false;
+    int   thresholdMin         = 60;
+    int   thresholdMax         = 250;
+    float backgroundPercentile = 99.f;  // 배경 밝기 = 검출 영역 히스토그램의 이 분위수 (%)
+    float thresholdRatio       = 0.5f;  // 임계값 = 배경 + (점 밝기 − 배경) × ratio
+    int   minContrast          = 40;    // 점이 없을 때 배경 + 이 값, 임계값의 배경 대비 최소 여유
+    int   hysteresis           = 6;     // 후보가 현재 임계값과 이만큼 이상 다를 때만 변경
+
+    bool  autoExposure         = false;
+    int   exposureMin          = 50;
+    int   exposureMax          = 7500;
+    int   targetPeak           = 230;   // 목표 점 밝기 (포화 직전)
+    int   peakBand             = 15;    // 목표 ± band 안이면 노출 유지
+    float exposureStep         = 0.15f; // 한 번에 바꿀 노출 비율
+    int   exposureInterval     = 6;     // 노출 변경 후 다음 변경까지 최소 처리 프레임 수 (반영 대기)
+
+    int   sampleStep           = 4;     // 히스토그램 표본 간격 (가로·세로 px)
+
+    bool operator==(const LevelParams& o) const
+    {
+        return threshold == o.threshold && autoThreshold == o.autoThreshold &&
+               thresholdMin == o.thresholdMin && thresholdMax == o.thresholdMax &&
+               backgroundPercentile == o.backgroundPercentile && thresholdRatio == o.thresholdRatio &&
+               minContrast == o.minContrast && hysteresis == o.hysteresis &&
+               autoExposure == o.autoExposure && exposureMin == o.exposureMin &&
+               exposureMax == o.exposureMax && targetPeak == o.targetPeak && peakBand == o.peakBand &&
+               exposureStep == o.exposureStep && exposureInterval == o.exposureInterval &&
+               sampleStep == o.sampleStep;
+    }
+    bool operator!=(const LevelParams& o) const { return !(*this == o); }
+};
+
+// ========== 히스토그램 기반 임계값 / 노출 컨트롤러 ==========
+// 카메라마다 하나, 처리 스레드 전용. 검출 직후 같은 프레임으로 update():
+//   1) 검출 영역을 sampleStep 간격으로 표본 추출한 256 bin 히스토그램 → 배경 밝기 (분위수)
+//   2) 검출된 블롭마다 바운딩 박스 안 최대 밝기 → 점 밝기 (상위 25% 지점, 잡음 블롭에 끌려가지 않게)
+//   3) 임계값 후보 = 배경과 점 밝기 사이 ratio 지점 (점이 없으면 배경 + minContrast), 히스테리시스 적용
+//   4) autoExposure 면 점 밝기를 targetPeak ± peakBand 로 맞추도록 노출을 exposureStep 비율씩 조절
+// 다음 프레임 검출부터 새 임계값을 쓰므로 한 프레임 늦게 반영된다.
+class LevelController
+{
+public:
+    // 설정/기준 노출이 바뀌었을 때만 상태를 초기화 (매 설정 갱신마다 불러도 됨)
+    void configure(const LevelParams& params, int exposure);
+
+    // gray: 전체 프레임 (stride == width), roi: 실제 검출 영역, blobs: 그 프레임 검출 결과 (프레임 좌표).
+    // 노출을 바꿔야 하면 true + exposureOut.
+    bool update(const uint8_t* gray, int width, int height, const cv::Rect& roi,
+                const std::vector<Blob>& blobs, int& exposureOut);
+
+    // 다음 검출에 쓸 임계값 (autoThreshold=0 이면 설정값 그대로)
+    int threshold()  const { return threshold_; }
+    int exposure()   const { return exposure_; }
+    int background() const { return background_; }
+    int peak()       const { return peak_; }           // 0 = 최근 프레임에 점 없음
+
+private:
+    static constexpr int MAX_PEAK_BLOBS = 64;
+
+    LevelParams params_;
+    int         baseExposure_ = -1;
+    bool        configured_   = false;
+
+    uint32_t         hist_[256] = {};
+    std::vector<int> peaks_;
+
+    int threshold_          = 200;
+    int exposure_           = 0;
+    int background_         = 0;
+    int peak_               = 0;
+    int framesSinceExposure_ = 0;
+};
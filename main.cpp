@@ -8,13 +8,35 @@
  * - 이진화(Threshold)를 통한 밝은 객체 검출
  * - 마우스 클릭으로 관심 영역(ROI) 선택 및 호모그래피 변환
  * - 시작/런타임 설정 다이얼로그 (IP, Port, 해상도, 노출)
+ * - 녹화 파일 재생 (--replay) 으로 카메라 없이 파이프라인 실행/벤치마크
+ * - 캡처 / 처리 스레드 분리: 표시·설정 다이얼로그가 검출 지연에 영향을 주지 않음
+ * - 다중 카메라 (camera_count): 카메라마다 캡처/검출 스레드 + 자기 4점 호모그래피,
+ *   공통 타깃 좌표에서 병합(중복 제거) 후 전송. 숫자 키로 표시 카메라 전환
+ * - 카메라 측 객체 모드 (object_mode=1): 카메라가 분할한 객체 목록만 받아 호모그래피/전송,
+ *   grayscale 은 표시할 프레임에서만 요청
+ * - 원시 프레임 녹화 (V 키 / --record): 원본 grayscale + 타임스탬프 + 검출 중심점을 청크·색인 파일(.irrec)로
+ *   별도 기록 스레드가 저장. 처리 스레드는 기다리지 않음 (버퍼가 모자라면 녹화 프레임만 버림)
+ *
+ * 명령행:
+ *   IRViewer.exe [--replay <file.irraw|file.irobj|file.irrec> [--replay <cam2...> ...]] [--replay-fast] [--replay-loop]
+ *                [--exit-on-end] [--headless] [--latency-csv <file.csv>] [--record-objects <file.irobj>]
+ *                [--record <file.irrec>]
+ *
+ * --replay 를 여러 번 주면 파일마다 카메라 하나로 재생 (다중 카메라 재현).
+ * .irobj (객체 목록) 파일은 카메라 객체 모드와 같은 경로로 재생된다.
+ * --record-objects: 처리한 프레임마다 검출 객체(중심점 + 면적)를 기록 (카메라가 여럿이면 _cam2 ... 접미사)
+ * --record: 시작부터 원시 프레임 녹화 (같은 접미사 규칙, V 키로 멈춤).
+ *           V 키로 새로 시작하는 녹화는 <exeDir>/recordings/IRViewer_<날짜_시각>.irrec
+ *
+ * --headless: 창/패널 렌더링 없이 검출 + 좌표 전송만 수행 (서비스 모드, Ctrl+C 로 종료)
+ * --latency-csv: 종료 시 단계별 지연 요약을 쓸 파일 (기본 IRViewer_latency.csv)
+ *
+ * Windows 이외 플랫폼 / IRTRACKING_WITH_OPTITRACK=OFF 빌드에서는 카메라와 설정 다이얼로그 없이
+ * --replay 소스만 사용 가능 (설정은 conf/setting.cfg).
  */
 
-// Winsock2는 반드시 Windows.h 이전에 포함해야 함
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-#include <winsock2.h>
+// Winsock2는 반드시 Windows.h 이전에 포함해야 함 (net_compat.h 가 먼저 포함)
+#include "net_compat.h"
 
 #include "settings.h"
 #include "homography.h"
@@ -22,23 +44,103 @@
 #include "frame_processor.h"
 #include "osd_renderer.h"
 #include "config_manager.h"
-
+#include "background_mask.h"
+#include "fiducial_calibration.h"
+#ifdef IRTRACKING_WITH_OPTITRACK
+#include "optitrack_source.h"
+#endif
+#include "replay_source.h"
+#include "object_list.h"
+#include "frame_recorder.h"
+#include "pipeline.h"
+#include "point_merger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
 #include <cstdint>
-#include "cameralibrary.h"
+#include <cstring>
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <ctime>
+#include <memory>
 #include <thread>
+#ifdef _WIN32
+#include <windows.h>
 #include <mmsystem.h>
 #pragma comment(lib, "winmm.lib")
+#endif
+
+// ========== 명령행 옵션 ==========
+struct CommandLineOptions
+{
+    std::vector<std::string> replayPaths; // 비어 있으면 OptiTrack 카메라 사용 (파일마다 카메라 하나)
+    bool        replayFast      = false; // 타임스탬프 무시, 최대 속도 재생
+    bool        replayLoop      = false;
+    bool        exitOnReplayEnd = false; // 재생 종료 시 자동 종료 (벤치마크용)
+    bool        headless        = false; // 트래킹 전용: 창/패널 렌더링 없음
+    std::string latencyCsvPath  = "IRViewer_latency.csv";
+    std::string recordObjectsPath;       // 비어 있으면 기록 안 함
+    std::string recordPath;              // 비어 있으면 시작 시 녹화 안 함 (V 키 녹화는 항상 자동 이름)
+};
+
+// 헤드리스 모드 종료 요청 (Ctrl+C)
+static std::atomic<bool> g_stopRequested{false};
+static void onStopSignal(int) { g_stopRequested.store(true); }
+
+static CommandLineOptions parseCommandLine(int argc, char* argv[])
+{
+    CommandLineOptions opt;
+    for (int i = 1; i < argc; i++)
+    {
+        if      (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) opt.replayPaths.push_back(argv[++i]);
+        else if (strcmp(argv[i], "--replay-fast") == 0)            opt.replayFast      = true;
+        else if (strcmp(argv[i], "--replay-loop") == 0)            opt.replayLoop      = true;
+        else if (strcmp(argv[i], "--exit-on-end") == 0)            opt.exitOnReplayEnd = true;
+        else if (strcmp(argv[i], "--headless") == 0)               opt.headless        = true;
+        else if (strcmp(argv[i], "--latency-csv") == 0 && i + 1 < argc) opt.latencyCsvPath = argv[++i];
+        else if (strcmp(argv[i], "--record-objects") == 0 && i + 1 < argc) opt.recordObjectsPath = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)         opt.recordPath        = argv[++i];
+    }
+    return opt;
+}
 
-using namespace CameraLibrary;
+// 카메라 2번부터 확장자 앞에 _cam{N} 접미사 (확장자가 없으면 끝에)
+static std::string withCameraSuffix(std::string path, int cam)
+{
+    if (cam == 0) return path;
+    size_t dot = path.find_last_of('.');
+    size_t cut = (dot == std::string::npos || path.find_first_of("/\\", dot) != std::string::npos)
+                 ? path.size() : dot;
+    path.insert(cut, "_cam" + std::to_string(cam + 1));
+    return path;
+}
+
+// V 키 녹화 기본 파일 이름: <exeDir>/recordings/IRViewer_YYYYMMDD_HHMMSS.irrec
+static std::string defaultRecordingPath()
+{
+    std::time_t now = std::time(nullptr);
+    std::tm     tm  = {};
+#ifdef _WIN32
+    localtime_s(&tm, &now);
+#else
+    localtime_r(&now, &tm);
+#endif
+    char name[64];
+    strftime(name, sizeof(name), "IRViewer_%Y%m%d_%H%M%S.irrec", &tm);
+    return getExeDir() + "recordings/" + name;
+}
 
 int main(int argc, char* argv[])
 {
+    CommandLineOptions options = parseCommandLine(argc, argv);
+
     // ========== Windows 타이머 해상도를 1ms로 설정 ==========
+#ifdef _WIN32
     timeBeginPeriod(1);
+#endif
 
     // ========== 로그 파일 설정 ==========
     std::ofstream logFile("IRViewer_log.txt");
@@ -58,11 +160,14 @@ int main(int argc, char* argv[])
               << std::chrono::system_clock::now().time_since_epoch().count() << std::endl;
 
     // ========== 설정 로드 (conf/setting.cfg) 또는 시작 다이얼로그 ==========
-    AppSettings settings;
-    std::vector<cv::Point2f> configCorners;
-    bool configLoaded = loadConfig(settings, configCorners);
-    if (!configLoaded)
+    AppSettings       settings;
+    CameraCorners     configCorners;
+    CameraBackgrounds backgrounds;
+    bool configLoaded = loadConfig(settings, configCorners, backgrounds);
+#ifdef _WIN32
+    if (!configLoaded && !options.headless)
         ShowSettingsDialog(settings); // 설정 파일이 없을 때만 다이얼로그 표시
+#endif
 
     std::cout << "Settings applied: IP=" << settings.ipAddress
               << " Port=" << settings.port
@@ -70,105 +175,64 @@ int main(int argc, char* argv[])
               << " TargetH=" << settings.targetHeight
               << " Exposure=" << settings.exposure << std::endl;
 
-    // ========== Camera SDK 초기화 ==========
-    std::cout << "Initializing Camera SDK..." << std::endl;
-    CameraManager::X().WaitForInitialization();
-
-    if (!CameraManager::X().AreCamerasInitialized())
-    {
-        std::cerr << "Failed to initialize cameras." << std::endl;
-        restoreLog();
-        MessageBoxA(NULL, "Failed to initialize Camera SDK. Check IRViewer_log.txt for details.",
-                    "Error", MB_OK | MB_ICONERROR);
-        return -1;
-    }
-    std::cout << "Camera SDK initialized successfully." << std::endl;
-
-    CameraList list;
-    std::cout << "Number of cameras detected: " << list.Count() << std::endl;
-
-    if (list.Count() == 0)
-    {
-        std::cerr << "No cameras found!" << std::endl;
-        restoreLog();
-        CameraManager::X().Shutdown();
-        MessageBoxA(NULL, "No OptiTrack cameras found. Check IRViewer_log.txt for details.",
-                    "Error", MB_OK | MB_ICONERROR);
-        return -1;
-    }
-
-    for (int i = 0; i < list.Count(); i++)
+    // ========== 프레임 소스 초기화 (카메라 또는 녹화 파일 재생, 카메라마다 하나) ==========
+    std::vector<std::unique_ptr<IFrameSource>> sources;
+    std::string sourceError;
+    if (!options.replayPaths.empty())
     {
-        std::cout << "Camera " << i << ": " << list[i].Name() << std::endl;
-        std::cout << "  UID: " << list[i].UID() << std::endl;
-        std::cout << std::dec; // UID() sets std::hex internally; reset to decimal
-        std::cout << "  Initial State: " << list[i].State() << std::endl;
-    }
-
-    std::cout << "Waiting for camera to fully initialize..." << std::endl;
-    bool cameraReady = false;
-    for (int i = 0; i < 100; i++) // 최대 10초 대기
-    {
-        CameraList cur;
-        if (cur.Count() > 0 && cur[0].State() == 6)
+        for (const std::string& path : options.replayPaths)
         {
-            cameraReady = true;
-            std::cout << "Camera initialized! (State: " << cur[0].State() << ")" << std::endl;
-            break;
+            if (static_cast<int>(sources.size()) == MAX_CAMERAS) break;
+            ReplayPacing pacing = options.replayFast ? ReplayPacing::AsFastAsPossible
+                                                     : ReplayPacing::Realtime;
+            std::unique_ptr<IFrameSource> replay = openRecording(path, pacing, options.replayLoop, sourceError);
+            if (!replay)
+            {
+                sources.clear();
+                break;
+            }
+            sources.push_back(std::move(replay));
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
-
-    if (!cameraReady)
+    else
     {
-        std::cerr << "Camera failed to initialize within 10 seconds." << std::endl;
-        restoreLog();
-        CameraManager::X().Shutdown();
-        MessageBoxA(NULL, "Camera initialization timeout. Check IRViewer_log.txt for details.",
-                    "Error", MB_OK | MB_ICONERROR);
-        return -1;
+#ifdef IRTRACKING_WITH_OPTITRACK
+        for (auto& camera : OptiTrackFrameSource::openAll(settings.exposure, settings.cameraCount,
+                                                            settings.objectMode, settings.objectThreshold,
+                                                            sourceError))
+            sources.push_back(std::move(camera));
+#else
+        sourceError = "Camera support not built (IRTRACKING_WITH_OPTITRACK=OFF). Use --replay <file.irraw>.";
+#endif
     }
 
-    std::cout << "Getting camera with UID: " << list[0].UID() << std::endl;
-    std::shared_ptr<Camera> camera = CameraManager::X().GetCamera(list[0].UID());
-
-    if (!camera)
+    if (sources.empty())
     {
-        std::cerr << "Failed to get camera pointer." << std::endl;
+        std::cerr << sourceError << std::endl;
         restoreLog();
-        CameraManager::X().Shutdown();
-        MessageBoxA(NULL, "Failed to get camera pointer. Check IRViewer_log.txt for details.",
-                    "Error", MB_OK | MB_ICONERROR);
+        std::string msg = sourceError + " Check IRViewer_log.txt for details.";
+#ifdef _WIN32
+        MessageBoxA(NULL, msg.c_str(), "Error", MB_OK | MB_ICONERROR);
+#else
+        std::cerr << msg << std::endl;
+#endif
         return -1;
     }
 
-    std::cout << "Camera Serial: " << camera->Serial() << std::endl;
-    std::cout << "Camera Name: "   << camera->Name()   << std::endl;
-    std::cout << "Camera Resolution: " << camera->Width() << "x" << camera->Height() << std::endl;
-
-    // ========== 카메라 설정 ==========
-    camera->SetVideoType(Core::GrayscaleMode);
-    std::cout << "Camera set to Grayscale mode." << std::endl;
-
-    camera->SetExposure(settings.exposure);
-    std::cout << "Exposure set to " << settings.exposure << "." << std::endl;
-
-    camera->SetIntensity(0);
-    std::cout << "IR illumination disabled (intensity set to 0)." << std::endl;
-
-    camera->Start();
-    std::cout << "Camera started." << std::endl;
+    int cameraCount = static_cast<int>(sources.size());
+    std::cout << "Cameras: " << cameraCount << std::endl;
 
     // ========== OpenCV 윈도우 & 마우스 콜백 ==========
-    int frameWidth  = camera->Width();
-    int frameHeight = camera->Height();
 
     std::string windowName = "OptiTrack Flex 13 - IR View";
-    cv::namedWindow(windowName, cv::WINDOW_AUTOSIZE | cv::WINDOW_GUI_NORMAL);
-
-    // X 버튼 제거: 시스템 메뉴에서 SC_CLOSE 항목 삭제
-    cv::waitKey(1); // 윈도우 핸들 생성 대기
+    if (!options.headless)
     {
+        cv::namedWindow(windowName, cv::WINDOW_AUTOSIZE | cv::WINDOW_GUI_NORMAL);
+
+#ifdef _WIN32
+        // X 버튼 제거: 시스템 메뉴에서 SC_CLOSE 항목 삭제
+        cv::waitKey(1); // 윈도우 핸들 생성 대기
+
         HWND hwnd = FindWindowA(nullptr, windowName.c_str());
         if (hwnd)
         {
@@ -179,124 +243,372 @@ int main(int argc, char* argv[])
                 DrawMenuBar(hwnd);
             }
         }
+#endif
+    }
+    else
+    {
+        std::signal(SIGINT, onStopSignal);
+        std::cout << "[Headless] Tracking-only mode. Press Ctrl+C to stop." << std::endl;
     }
 
-    HomographyState hom;
+    // 카메라마다 자기 4점 호모그래피 → 모두 같은 타깃 좌표계
+    std::vector<HomographyState> homs(cameraCount);
 
     // conf/setting.cfg 에 저장된 4개 코너가 있으면 호모그래피 즉시 복원
-    if (configLoaded &&
-        static_cast<int>(configCorners.size()) == HomographyState::REQUIRED_POINTS)
+    for (int cam = 0; cam < cameraCount; cam++)
     {
-        hom.selectedPoints = configCorners;
-        float tw = static_cast<float>(settings.targetWidth  - 1);
-        float th = static_cast<float>(settings.targetHeight - 1);
-        std::vector<cv::Point2f> dst = { {0.f,0.f},{tw,0.f},{tw,th},{0.f,th} };
-        hom.matrix = cv::getPerspectiveTransform(hom.selectedPoints, dst);
-        hom.ready  = true;
-        std::cout << "[Config] Homography restored from saved corners." << std::endl;
+        if (!configLoaded || cam >= static_cast<int>(configCorners.size()) ||
+            static_cast<int>(configCorners[cam].size()) != HomographyState::REQUIRED_POINTS)
+            continue;
+        homs[cam].selectedPoints = configCorners[cam];
+        computeHomography(homs[cam], settings.targetWidth, settings.targetHeight, settings.lens);
+        std::cout << "[Config] Camera " << cam + 1 << " homography restored from saved corners." << std::endl;
     }
 
+    // 표시 / 마우스 / 자동 캘리브레이션 대상 카메라 (숫자 키로 전환)
+    int activeCamera = 0;
+
     static MouseCallbackData mouseData;
     mouseData.windowName   = windowName;
-    mouseData.frameWidth   = frameWidth;
-    mouseData.frameHeight  = frameHeight;
     mouseData.targetWidth  = settings.targetWidth;
     mouseData.targetHeight = settings.targetHeight;
-    mouseData.state        = &hom;
-    cv::setMouseCallback(windowName, onMouse, &mouseData);
+    mouseData.lens         = &settings.lens;
+    auto selectMouseCamera = [&]()
+    {
+        mouseData.frameWidth  = sources[activeCamera]->width();
+        mouseData.frameHeight = sources[activeCamera]->height();
+        mouseData.state       = &homs[activeCamera];
+    };
+    selectMouseCamera();
+    if (!options.headless)
+        cv::setMouseCallback(windowName, onMouse, &mouseData);
 
     std::cout << "Instructions:" << std::endl;
-    std::cout << "  [Q/ESC] Quit  [S] UDP toggle  [R] Reset  [P] Settings" << std::endl;
-    std::cout << "  Left-click on LEFT image to select 4 corner points." << std::endl;
+    std::cout << "  [Q/ESC] Quit  [S] UDP toggle  [R] Reset  [P] Settings  [C] Auto-calibrate"
+                 "  [B] Learn background  [V] Record raw frames" << std::endl;
+    if (cameraCount > 1)
+        std::cout << "  [1-" << cameraCount << "] Select camera to view / calibrate" << std::endl;
+    std::cout << "  Left-click on LEFT image to select 4 corner points," << std::endl;
+    std::cout << "  or press C with the IR fiducial grid visible." << std::endl;
 
     // ========== UDP 초기화 ==========
-    WSADATA wsaData;
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+    if (!netStartup())
     {
-        std::cerr << "WSAStartup failed. Error: " << WSAGetLastError() << std::endl;
-        CameraManager::X().Shutdown();
+        std::cerr << "Network startup failed. Error: " << netLastError() << std::endl;
         return -1;
     }
 
-    UDPSender sender;
+    // 종단 간 지연 (acquire → detect → 전송 스레드 전달 → sendto). 전송 스레드가 기록.
+    LatencyTrace latencyTrace;
+    UDPSender    sender;
+    sender.setLatencyTrace(&latencyTrace);
     if (!sender.init(settings.ipAddress, settings.port))
     {
-        WSACleanup();
-        CameraManager::X().Shutdown();
+        netCleanup();
         return -1;
     }
+    sender.setExtraTargets(settings.udpTargets);
+    sender.setMulticastTtl(settings.udpMulticastTtl);
+    sender.setDecimals(settings.udpDecimals);
+    sender.setFormat(settings.udpFormat, settings.udpSendArea);
+    sender.setSendMode(settings.udpSendMode, settings.udpMinIntervalUs, settings.udpKeepaliveMs);
+    sender.setExtrapolation(settings.udpExtrapolateMs, settings.targetWidth, settings.targetHeight);
+    if (settings.udpExtrapolateMs > 0 && !settings.tracking)
+        std::cerr << "[UDP] udp_extrapolate_ms needs tracking=1 (velocities); sending raw points." << std::endl;
     std::cout << "UDP socket ready. Target: " << settings.ipAddress << ":" << settings.port << std::endl;
     std::cout << "Press 'u' to toggle UDP send thread." << std::endl;
 
-    // ========== 메인 루프 ==========
+    // ========== 파이프라인 (카메라마다 캡처 / 처리 스레드) + 병합 ==========
+    // 메인 스레드는 표시 + 키/마우스 + 설정 다이얼로그만 담당한다.
+    // homs / settings 는 메인 스레드 소유이고, 바뀔 때마다 처리 스레드에 복사본을 게시한다.
+    PointMerger merger(sender, cameraCount);
+    std::vector<std::unique_ptr<TrackingPipeline>> pipelines;
+    for (int cam = 0; cam < cameraCount; cam++)
+        pipelines.push_back(std::make_unique<TrackingPipeline>(*sources[cam], merger, cam));
+
+    // 검출 객체 기록 (.irobj): 나중에 --replay 로 카메라 없이 같은 경로 재현
+    if (!options.recordObjectsPath.empty())
+    {
+        for (int cam = 0; cam < cameraCount; cam++)
+        {
+            std::string path = withCameraSuffix(options.recordObjectsPath, cam);
+            std::string recordError;
+            auto writer = ObjectListWriter::open(path, sources[cam]->width(), sources[cam]->height(),
+                                                 recordError);
+            if (writer)
+                pipelines[cam]->recordObjects(std::move(writer));
+            else
+                std::cerr << recordError << std::endl;
+        }
+    }
+
+    // 원시 프레임 녹화 (.irrec): 모든 카메라를 같이 켜고 끔
+    auto recording = [&]()
+    {
+        return std::any_of(pipelines.begin(), pipelines.end(),
+                           [](const std::unique_ptr<TrackingPipeline>& p) { return p->recorder().recording(); });
+    };
+    auto stopRecording = [&]()
+    {
+        for (auto& p : pipelines) p->recorder().stop();
+    };
+    // 한 카메라라도 실패하면 이미 시작한 카메라도 멈춰 일부만 녹화되는 상태를 남기지 않음
+    auto startRecording = [&](const std::string& basePath)
+    {
+        FrameRecorderOptions recordOptions;
+        recordOptions.chunkFrames = settings.recordChunkFrames;
+        recordOptions.buffers     = settings.recordBuffers;
+        recordOptions.lz4         = settings.recordLz4;
+        for (int cam = 0; cam < cameraCount; cam++)
+        {
+            std::string recordError;
+            if (!pipelines[cam]->recorder().start(withCameraSuffix(basePath, cam), sources[cam]->width(),
+                                                  sources[cam]->height(), sources[cam]->objectMode(),
+                                                  recordOptions, recordError))
+            {
+                std::cerr << recordError << std::endl;
+                stopRecording();
+                return;
+            }
+        }
+    };
+    if (!options.recordPath.empty())
+        startRecording(options.recordPath);
+
+    // 설정 파일에 없는 카메라는 빈 마스크 (억제 안 함)
+    backgrounds.resize(cameraCount);
+
+    std::vector<std::vector<cv::Point2f>> publishedPoints(cameraCount);
+    std::vector<bool>                     publishedReady(cameraCount, false);
+    auto publishCamera = [&](int cam)
+    {
+        pipelines[cam]->publishConfig(homs[cam], settings, backgrounds[cam]);
+        publishedPoints[cam] = homs[cam].selectedPoints;
+        publishedReady[cam]  = homs[cam].ready;
+    };
+    auto publishConfig = [&]()
+    {
+        for (int cam = 0; cam < cameraCount; cam++) publishCamera(cam);
+    };
+    // 마우스 콜백이 코너를 바꿨을 수 있으므로 매 루프 비교 (카메라당 최대 4점)
+    auto publishIfHomChanged = [&]()
+    {
+        for (int cam = 0; cam < cameraCount; cam++)
+        {
+            if (homs[cam].ready != publishedReady[cam] || homs[cam].selectedPoints != publishedPoints[cam])
+                publishCamera(cam);
+        }
+    };
+    publishConfig();
+
     bool running        = true;
     // 설정 파일에서 4점이 복원됐으면 UDP 스트리밍 자동 시작
-    bool continuousSend = (configLoaded && hom.ready);
+    bool anyReady = false;
+    for (const HomographyState& h : homs) anyReady = anyReady || h.ready;
+    bool continuousSend = (configLoaded && anyReady);
     if (continuousSend)
     {
         sender.startThread(settings.udpFps);
         std::cout << "[Config] Auto-started UDP streaming at " << settings.udpFps << " FPS." << std::endl;
     }
+    merger.setSending(continuousSend);
+    for (int cam = 0; cam < cameraCount; cam++)
+    {
+        pipelines[cam]->setDisplayEnabled(cam == activeCamera);
+        pipelines[cam]->start(!options.headless);
+    }
+    auto allDrained = [&]()
+    {
+        for (const auto& p : pipelines)
+            if (!p->drained()) return false;
+        return true;
+    };
 
-    std::vector<cv::Point2f> latestSendCenters; // 마지막으로 검출된 전송 대상 좌표
+    // 카메라별 처리 FPS (1초마다 갱신, OSD 용)
+    std::vector<long> lastProcessed(cameraCount, 0);
+    std::vector<int>  cameraFps(cameraCount, 0);
+
+    // 표시 전용 처리기 + 디스플레이 버퍼 (검출 스레드와 버퍼를 공유하지 않음)
+    // displaySettings = settings + 처리 스레드의 현재 임계값 (자동 임계값이 저장 설정을 바꾸지 않게 사본)
+    FrameProcessor displayProcessor;
+    AppSettings    displaySettings;
+    cv::Mat        combined;
 
     // K키 저장 확인 메시지용 타이머
     bool showConfigSaved = false;
     auto configSavedTime = std::chrono::steady_clock::time_point{};
 
-    int displayCounter = 0;
+    // [C] 기준점 격자 자동 캘리브레이션: 표시 프레임 AUTO_CALIB_FRAMES 장의 검출 결과를 모아 추정
+    static constexpr int AUTO_CALIB_FRAMES = 30;
+    std::unique_ptr<FiducialCalibrator> autoCalib;
+    HomographyState                     homBeforeCalib;
+    int                                 autoCalibFrames = 0;
+    auto finishAutoCalibration = [&]()
+    {
+        HomographyState& hom = homs[activeCamera];  // 수집 중엔 카메라 전환 불가
+        FiducialFitResult fit = autoCalib->solve();
+        autoCalib.reset();
+        if (!fit.ok)
+        {
+            hom = homBeforeCalib;
+            std::cerr << "[Calib] Auto calibration failed: " << fit.error
+                      << ". Previous corners restored." << std::endl;
+            return;
+        }
+        hom.selectedPoints = fit.corners;
+        computeHomography(hom, settings.targetWidth, settings.targetHeight, settings.lens);
+        std::cout << "[Calib] Camera " << activeCamera + 1 << " homography from " << fit.inliers << "/" << fit.correspondences
+                  << " fiducial points over " << fit.frames << " frame(s): RMS " << fit.rmsPx
+                  << " px, max " << fit.maxPx << " px. Press S to save." << std::endl;
+    };
+
+    // [B] 정적 배경 학습: 타깃 없이 backgroundLearnMs 동안 표시 프레임을 누적해 마스크 생성.
+    // 학습 중에는 그 카메라의 기존 마스크를 내려 둬야 억제 전 원본 프레임이 들어옴.
+    std::unique_ptr<BackgroundLearner> bgLearner;
+    BackgroundMask                     backgroundBeforeLearn;
+    auto                               bgLearnStart = std::chrono::steady_clock::time_point{};
+    auto finishBackgroundLearning = [&]()
+    {
+        std::string    error;
+        BackgroundMask mask = bgLearner->finish(settings.backgroundPresence, settings.backgroundGrowPx, error);
+        int            frames = bgLearner->frames();
+        bgLearner.reset();
+        if (!error.empty())
+        {
+            backgrounds[activeCamera] = backgroundBeforeLearn;
+            std::cerr << "[Background] Learning failed: " << error << ". Previous mask restored." << std::endl;
+        }
+        else
+        {
+            backgrounds[activeCamera] = mask;
+            std::cout << "[Background] Camera " << activeCamera + 1 << " mask from " << frames << " frame(s): "
+                      << mask.pixelCount() << " px in " << mask.runCount() << " run(s). Press S to save." << std::endl;
+        }
+        publishCamera(activeCamera);
+    };
+
+    auto loopStart   = std::chrono::steady_clock::now();
+    auto latencyRoll = loopStart;
+
+    // 헤드리스: 실제 작업은 파이프라인 / 전송 스레드. 메인 스레드는 종료 조건만 기다리며 잠든다
+    // (Ctrl+C 처리기에서는 condvar 를 깨울 수 없으므로 원자 플래그를 100ms 간격으로 확인, 코어를 점유하지 않음)
+    if (options.headless)
+    {
+        while (!g_stopRequested.load() && !(options.exitOnReplayEnd && allDrained()))
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        running = false;
+    }
+
     while (running)
     {
-        std::shared_ptr<const Frame> frame = camera->LatestFrame();
+        if (options.exitOnReplayEnd && allDrained())
+            running = false;
+
+        HomographyState&  hom      = homs[activeCamera];
+        TrackingPipeline& pipeline = *pipelines[activeCamera];
 
-        bool doDisplay = false;
-        if (frame && frame->IsGrayscale())
+        // ===== 표시: 처리 스레드가 넘긴 최신 프레임이 있을 때만 패널 렌더링 + OSD =====
+        if (const PipelineFrame* frame = pipeline.acquireDisplayFrame())
         {
-            const unsigned char* data = frame->GrayscaleData(*camera);
-            if (data)
+            PipelineStats ps = pipeline.stats();
+            displaySettings = settings;
+            if (ps.threshold > 0) displaySettings.levels.threshold = ps.threshold;
+            const FrameResult& r = displayProcessor.process(frame->pixels.data(), frame->width,
+                                                            frame->height, hom, displaySettings);
+
+            if (autoCalib)
             {
-                FrameResult r = processFrame(data, frameWidth, frameHeight, hom, settings);
+                autoCalib->addFrame(r.detectedCenters);
+                if (++autoCalibFrames >= AUTO_CALIB_FRAMES) finishAutoCalibration();
+            }
 
-                // 전송 대상 좌표 갱신
-                latestSendCenters = hom.ready ? r.inBoundCenters : std::vector<cv::Point2f>{};
+            if (bgLearner)
+            {
+                if (frame->width == bgLearner->width() && frame->height == bgLearner->height())
+                    bgLearner->addFrame(frame->pixels.data());
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - bgLearnStart).count();
+                if (ms >= settings.backgroundLearnMs) finishBackgroundLearning();
+            }
 
-                // ===== 최신 좌표를 전송 스레드에 전달 =====
-                if (continuousSend && hom.ready)
-                    sender.updatePoints(latestSendCenters);
+            // 저장 확인 메시지 타이머 체크 (2초 후 소멸)
+            if (showConfigSaved)
+            {
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - configSavedTime).count();
+                if (ms > 2000) showConfigSaved = false;
+            }
 
-                // ===== 디스플레이 쓰로틀: 4프레임마다 1회 표시 (~30fps) =====
-                if (++displayCounter % 4 == 0)
+            // OSD 지연 분위수 / 카메라별 FPS 는 최근 1초 구간
+            auto now = std::chrono::steady_clock::now();
+            if (now - latencyRoll >= std::chrono::seconds(1))
+            {
+                latencyTrace.roll();
+                double sec = std::chrono::duration<double>(now - latencyRoll).count();
+                for (int cam = 0; cam < cameraCount; cam++)
                 {
-                    // 저장 확인 메시지 타이머 체크 (2초 후 소멸)
-                    if (showConfigSaved)
-                    {
-                        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::steady_clock::now() - configSavedTime).count();
-                        if (ms > 2000) showConfigSaved = false;
-                    }
-
-                    cv::Mat combined;
-                    cv::hconcat(r.leftPanel, r.rightPanel, combined);
-
-                    OSDState osd;
-                    osd.continuousSend     = continuousSend;
-                    osd.homographyReady    = hom.ready;
-                    osd.selectedPointCount = static_cast<int>(hom.selectedPoints.size());
-                    osd.displayCount       = hom.ready
-                                            ? static_cast<int>(r.inBoundCenters.size())
-                                            : static_cast<int>(r.detectedCenters.size());
-                    osd.configSaved        = showConfigSaved;
-                    osd.udpActualFps       = sender.actualFps();
-                    renderOSD(combined, osd);
-
-                    cv::imshow(windowName, combined);
-                    doDisplay = true;
+                    long processed     = pipelines[cam]->stats().processedFrames;
+                    cameraFps[cam]     = static_cast<int>((processed - lastProcessed[cam]) / sec + 0.5);
+                    lastProcessed[cam] = processed;
                 }
+                latencyRoll = now;
+            }
+
+            cv::hconcat(r.leftPanel, r.rightPanel, combined);
+            pipeline.releaseDisplayFrame();
+
+            OSDState osd;
+            osd.continuousSend     = continuousSend;
+            osd.homographyReady    = hom.ready;
+            osd.selectedPointCount = static_cast<int>(hom.selectedPoints.size());
+            osd.displayCount       = hom.ready
+                                    ? static_cast<int>(r.inBoundCenters.size())
+                                    : static_cast<int>(r.detectedCenters.size());
+            osd.configSaved        = showConfigSaved;
+            osd.udpActualFps       = sender.actualFps();
+            const LatencyWindow& total = latencyTrace.window(LatencyTrace::Total);
+            osd.latencyP50Us       = static_cast<int>(total.percentileUs(0.50));
+            osd.latencyP95Us       = static_cast<int>(total.percentileUs(0.95));
+            osd.latencyP99Us       = static_cast<int>(total.percentileUs(0.99));
+            osd.detectP99Us        = static_cast<int>(latencyTrace.window(LatencyTrace::Detect).percentileUs(0.99));
+            osd.handoffP99Us       = static_cast<int>(latencyTrace.window(LatencyTrace::Handoff).percentileUs(0.99));
+            osd.sendP99Us          = static_cast<int>(latencyTrace.window(LatencyTrace::Send).percentileUs(0.99));
+            osd.frameAllocations   = ps.frameAllocations + displayProcessor.lastFrameAllocations();
+            osd.captureQueue       = ps.captureQueue;
+            osd.displayQueue       = ps.displayQueue;
+            osd.droppedFrames      = ps.captureDrops + ps.staleDrops;
+            osd.displayDrops       = ps.displayDrops;
+            osd.threshold          = displaySettings.levels.threshold;
+            osd.exposure           = settings.levels.autoExposure ? ps.exposure : settings.exposure;
+            osd.autoThreshold      = settings.levels.autoThreshold;
+            osd.autoExposure       = settings.levels.autoExposure;
+            osd.background         = ps.background;
+            osd.peak               = ps.peak;
+            osd.cameraCount        = cameraCount;
+            osd.activeCamera       = activeCamera;
+            osd.learningBackground = bgLearner != nullptr;
+            osd.recording          = recording();
+            for (const auto& p : pipelines)
+            {
+                osd.recordFrames += p->recorder().framesRecorded();
+                osd.recordDrops  += p->recorder().droppedFrames();
+                osd.recordMB     += static_cast<long>(p->recorder().bytesWritten() / (1024 * 1024));
+            }
+            osd.backgroundPixels   = settings.backgroundSuppression
+                                    ? static_cast<long>(backgrounds[activeCamera].pixelCount()) : 0;
+            for (int cam = 0; cam < cameraCount; cam++)
+            {
+                PipelineStats cs = cam == activeCamera ? ps : pipelines[cam]->stats();
+                osd.cameraFps[cam]   = cameraFps[cam];
+                osd.cameraDrops[cam] = cs.captureDrops + cs.staleDrops;
             }
+            renderOSD(combined, osd);
+
+            cv::imshow(windowName, combined);
         }
 
-        // ===== 키 입력 처리: 표시 프레임엔 waitKey(1), 아니면 pollKey() (논블로킹) =====
-        int key = doDisplay ? cv::waitKey(1) : cv::pollKey();
+        // ===== 키 입력 처리 (waitKey 가 창 메시지 펌프도 겸함) =====
+        int key = cv::waitKey(1);
 
         if (key == 'q' || key == 'Q' || key == 27)
         {
@@ -305,7 +617,6 @@ int main(int argc, char* argv[])
         else if (key == 'r' || key == 'R')
         {
             hom.reset();
-            latestSendCenters.clear();
             std::cout << "Point selection reset." << std::endl;
         }
         else if (key == 'u' || key == 'U')
@@ -315,10 +626,53 @@ int main(int argc, char* argv[])
                 sender.startThread(settings.udpFps);
             else
                 sender.stopThread();
+            merger.setSending(continuousSend);
+        }
+        else if ((key == 'c' || key == 'C') && !autoCalib && !bgLearner)
+        {
+            // 기존 호모그래피의 ROI 에 가려지지 않도록 전체 프레임 검출로 돌려 놓고 수집
+            homBeforeCalib  = hom;
+            hom.reset();
+            autoCalib       = std::make_unique<FiducialCalibrator>(settings.fiducial, settings.targetWidth,
+                                                                   settings.targetHeight, settings.lens);
+            autoCalibFrames = 0;
+            std::cout << "[Calib] Collecting " << settings.fiducial.cols << "x" << settings.fiducial.rows
+                      << " fiducial grid over " << AUTO_CALIB_FRAMES << " frames..." << std::endl;
+        }
+        else if (key == 'v' || key == 'V')
+        {
+            if (recording())
+                stopRecording();
+            else
+                startRecording(defaultRecordingPath());     // --record 파일을 덮어쓰지 않도록 새 이름
+        }
+        else if ((key == 'b' || key == 'B') && !autoCalib && !bgLearner)
+        {
+            // 학습 임계: 검출 임계값보다 margin 만큼 어두운 픽셀까지 "밝음" 으로 봐서 가장자리까지 덮음
+            int detectLevel = settings.levels.autoThreshold ? settings.levels.thresholdMin : settings.levels.threshold;
+            backgroundBeforeLearn     = backgrounds[activeCamera];
+            backgrounds[activeCamera] = BackgroundMask();
+            publishCamera(activeCamera);
+            bgLearner    = std::make_unique<BackgroundLearner>(sources[activeCamera]->width(),
+                                                               sources[activeCamera]->height(),
+                                                               std::max(0, detectLevel - settings.backgroundMargin));
+            bgLearnStart = std::chrono::steady_clock::now();
+            std::cout << "[Background] Learning camera " << activeCamera + 1 << " background for "
+                      << settings.backgroundLearnMs << " ms. Keep targets out of view..." << std::endl;
+        }
+        else if (key >= '1' && key < '1' + cameraCount && !autoCalib && !bgLearner && key - '1' != activeCamera)
+        {
+            pipelines[activeCamera]->setDisplayEnabled(false);
+            activeCamera = key - '1';
+            pipelines[activeCamera]->setDisplayEnabled(true);
+            selectMouseCamera();
+            std::cout << "[Camera] Viewing camera " << activeCamera + 1 << "/" << cameraCount << std::endl;
         }
         else if (key == 's' || key == 'S')
         {
-            if (saveConfig(settings, hom.selectedPoints))
+            CameraCorners corners;
+            for (const HomographyState& h : homs) corners.push_back(h.selectedPoints);
+            if (saveConfig(settings, corners, backgrounds))
             {
                 showConfigSaved = true;
                 configSavedTime = std::chrono::steady_clock::now();
@@ -326,12 +680,14 @@ int main(int argc, char* argv[])
         }
         else if (key == 'p' || key == 'P')
         {
+            // 모달 다이얼로그 동안에도 캡처/처리/전송 스레드는 계속 동작
+#ifdef _WIN32
             AppSettings prev = settings;
             if (ShowSettingsDialog(settings))
             {
                 if (settings.exposure != prev.exposure)
                 {
-                    camera->SetExposure(settings.exposure);
+                    for (auto& p : pipelines) p->requestExposure(settings.exposure);
                     std::cout << "[Settings] Exposure updated to " << settings.exposure << std::endl;
                 }
                 if (strcmp(settings.ipAddress, prev.ipAddress) != 0 ||
@@ -348,24 +704,50 @@ int main(int argc, char* argv[])
                 {
                     mouseData.targetWidth  = settings.targetWidth;
                     mouseData.targetHeight = settings.targetHeight;
-                    hom.reset();
-                    latestSendCenters.clear();
+                    for (HomographyState& h : homs) h.reset();
+                    sender.setExtrapolation(settings.udpExtrapolateMs,
+                                            settings.targetWidth, settings.targetHeight);
                     std::cout << "[Settings] Target resolution changed to "
                               << settings.targetWidth << "x" << settings.targetHeight
                               << ". Homography reset." << std::endl;
                 }
+                publishConfig();
             }
+#else
+            std::cout << "[Settings] Dialog is Windows-only; edit conf/setting.cfg instead." << std::endl;
+#endif
         }
+
+        publishIfHomChanged();
     }
 
     // ========== 정리 및 종료 ==========
+    for (auto& p : pipelines) p->stop();
+    double elapsedSec = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - loopStart).count();
+    for (int cam = 0; cam < cameraCount; cam++)
+    {
+        long processedFrames = pipelines[cam]->stats().processedFrames;
+        std::cout << "Camera " << cam + 1 << ": processed " << processedFrames << " frames in "
+                  << elapsedSec << " s (" << (elapsedSec > 0 ? processedFrames / elapsedSec : 0.0)
+                  << " fps), " << pipelines[cam]->totalAllocations() << " buffer allocation(s)." << std::endl;
+    }
+    if (cameraCount > 1)
+        std::cout << "Merged " << merger.duplicatesMerged() << " duplicate point(s) from overlapping cameras."
+                  << std::endl;
+
     sender.stopThread();
+    latencyTrace.print(std::cout);
+    latencyTrace.writeCsv(options.latencyCsvPath);
     cv::destroyAllWindows();
-    WSACleanup();
-    CameraManager::X().Shutdown();
+    netCleanup();
+    pipelines.clear();
+    sources.clear(); // 카메라 소스는 여기서 Camera SDK 종료
 
     std::cout << "Program terminated successfully." << std::endl;
     restoreLog();
+#ifdef _WIN32
     timeEndPeriod(1);
+#endif
     return 0;
 }
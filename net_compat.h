@@ -0,0 +1,55 @@
+#pragma once
+
+// ========== 소켓 API 플랫폼 추상화 (Winsock / POSIX) ==========
+// 코어 라이브러리(udp_sender 등)는 이 헤더만 사용하고 winsock2.h / sys/socket.h 를 직접 포함하지 않는다.
+
+#ifdef _WIN32
+// Winsock2는 반드시 Windows.h 이전에 포함해야 함
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+using NetSocket = SOCKET;
+constexpr NetSocket INVALID_NET_SOCKET = INVALID_SOCKET;
+
+// WSAStartup / WSACleanup (프로세스당 1회, main 에서 호출). 실패 메시지는 플랫폼 중립 ("Network startup")
+inline bool netStartup()
+{
+    WSADATA wsaData;
+    return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+}
+inline void netCleanup()                { WSACleanup(); }
+inline int  netLastError()              { return WSAGetLastError(); }
+inline void netClose(NetSocket s)       { closesocket(s); }
+inline bool netSetNonBlocking(NetSocket s)
+{
+    u_long nonBlocking = 1;
+    return ioctlsocket(s, FIONBIO, &nonBlocking) == 0;
+}
+
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using NetSocket = int;
+constexpr NetSocket INVALID_NET_SOCKET = -1;
+
+inline bool netStartup()                { return true; }
+inline void netCleanup()                {}
+inline int  netLastError()              { return errno; }
+inline void netClose(NetSocket s)       { close(s); }
+inline bool netSetNonBlocking(NetSocket s)
+{
+    int flags = fcntl(s, F_GETFL, 0);
+    return flags >= 0 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+#endif
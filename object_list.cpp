@@ -0,0 +1,258 @@
+#include "object_list.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+
+// 프레임 레코드 최대 크기 / 블록 하나에 담는 최대 프레임 수
+static constexpr size_t MAX_OBJECT_FRAME_BYTES = sizeof(ObjectFrameHeader) + MAX_SOURCE_OBJECTS * sizeof(ObjectRecord);
+static constexpr size_t OBJECT_BLOCK_BYTES     = 64 * 1024;
+static_assert(OBJECT_BLOCK_BYTES >= 4 * MAX_OBJECT_FRAME_BYTES, "object list block too small");
+
+bool isObjectListFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    char magic[4] = {};
+    return in.read(magic, sizeof(magic)) && memcmp(magic, "IROB", 4) == 0;
+}
+
+// ─────────────────────────────────────────────────────────
+//  ObjectListWriter
+// ─────────────────────────────────────────────────────────
+
+std::unique_ptr<ObjectListWriter> ObjectListWriter::open(const std::string& path, int width, int height,
+                                                         std::string& errorOut)
+{
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f)
+    {
+        errorOut = "Cannot create object list file: " + path;
+        return nullptr;
+    }
+
+    // frameCount = 0: 재생 시 파일 끝까지 (비정상 종료로 잘린 파일도 읽을 수 있게 갱신하지 않음)
+    ObjectFileHeader hdr = {};
+    memcpy(hdr.magic, "IROB", 4);
+    hdr.version = 1;
+    hdr.width   = static_cast<uint32_t>(width);
+    hdr.height  = static_cast<uint32_t>(height);
+    if (fwrite(&hdr, sizeof(hdr), 1, f) != 1)
+    {
+        fclose(f);
+        errorOut = "Cannot write object list file: " + path;
+        return nullptr;
+    }
+    setvbuf(f, nullptr, _IONBF, 0);         // 블록 단위로 직접 쓰기 (stdio 버퍼 복사 생략)
+
+    // 모든 블록을 여기서 한 번만 할당 (기록 중 처리/기록 스레드는 할당하지 않음)
+    std::unique_ptr<ObjectListWriter> w(new ObjectListWriter());
+    w->file_ = f;
+    w->blocks_.resize(BLOCK_COUNT);
+    w->used_.assign(BLOCK_COUNT, 0);
+    for (int i = 0; i < BLOCK_COUNT; i++)
+    {
+        w->blocks_[i].resize(OBJECT_BLOCK_BYTES);
+        w->freeBlocks_.push(i);
+    }
+    w->writer_ = std::thread(&ObjectListWriter::writerLoop, w.get());
+    std::cout << "[ObjectList] Recording to " << path << std::endl;
+    return w;
+}
+
+ObjectListWriter::~ObjectListWriter()
+{
+    if (!file_) return;
+
+    // 처리 스레드는 이미 멈춤 — 채우다 만 블록을 대신 넘기고 기록 스레드가 비울 때까지 대기
+    if (current_ >= 0 && used_[current_] > 0)
+        filled_.push(current_);
+    current_ = -1;
+    stopping_.store(true);
+    wakeCv_.notify_one();
+    writer_.join();
+
+    fclose(file_);
+    if (writeFailed_)
+        std::cerr << "[ObjectList] Write error; recording is truncated." << std::endl;
+    std::cout << "[ObjectList] Recorded " << frames_.load() << " frame(s), dropped " << drops_.load()
+              << "." << std::endl;
+}
+
+void ObjectListWriter::write(uint32_t frameId, double timestamp, const std::vector<Blob>& blobs)
+{
+    uint32_t count = static_cast<uint32_t>(std::min<size_t>(blobs.size(), MAX_SOURCE_OBJECTS));
+    size_t   bytes = sizeof(ObjectFrameHeader) + count * sizeof(ObjectRecord);
+
+    // 남은 자리가 모자라면 채운 블록을 넘기고 새 블록을 잡음
+    if (current_ >= 0 && used_[current_] + bytes > OBJECT_BLOCK_BYTES)
+    {
+        // 블록 수 ≤ 링 용량이라 push 는 실패하지 않음
+        filled_.push(current_);
+        current_ = -1;
+        wakeCv_.notify_one();
+    }
+    if (current_ < 0)
+    {
+        // 빈 블록이 없으면 기록 스레드가 밀린 것 — 기다리지 않고 이 프레임을 버림
+        if (!freeBlocks_.pop(current_))
+        {
+            current_ = -1;
+            drops_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        used_[current_] = 0;
+    }
+
+    uint8_t* dst = blocks_[current_].data() + used_[current_];
+    ObjectFrameHeader fh;
+    fh.timestampUs = static_cast<uint64_t>(std::max(0.0, timestamp) * 1e6 + 0.5);
+    fh.frameId     = frameId;
+    fh.objectCount = count;
+    memcpy(dst, &fh, sizeof(fh));
+    dst += sizeof(fh);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ObjectRecord r{ blobs[i].cx, blobs[i].cy, static_cast<uint32_t>(blobs[i].area) };
+        memcpy(dst, &r, sizeof(r));
+        dst += sizeof(r);
+    }
+    used_[current_] += bytes;
+    frames_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ObjectListWriter::writerLoop()
+{
+    for (;;)
+    {
+        int block;
+        if (filled_.pop(block))
+        {
+            // 프레임 경계에서만 블록을 넘기므로 쓰기 실패로 잘려도 앞 프레임들은 재생 가능
+            if (!writeFailed_ && fwrite(blocks_[block].data(), 1, used_[block], file_) != used_[block])
+                writeFailed_ = true;
+            freeBlocks_.push(block);
+            continue;
+        }
+        if (stopping_.load() && filled_.empty()) break;
+
+        // 링은 lock-free, 대기만 condvar (알림을 놓쳐도 짧은 타임아웃으로 다시 확인)
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wakeCv_.wait_for(lock, std::chrono::milliseconds(20));
+    }
+}
+
+// ─────────────────────────────────────────────────────────
+//  ObjectReplaySource
+// ─────────────────────────────────────────────────────────
+
+std::unique_ptr<ObjectReplaySource> ObjectReplaySource::open(const std::string& path,
+                                                             ReplayPacing pacing,
+                                                             bool loop,
+                                                             std::string& errorOut)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        errorOut = "Cannot open object list file: " + path;
+        return nullptr;
+    }
+
+    std::unique_ptr<ObjectReplaySource> src(new ObjectReplaySource());
+    src->data_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    ObjectFileHeader hdr;
+    if (src->data_.size() < sizeof(hdr))
+    {
+        errorOut = "Object list file too small: " + path;
+        return nullptr;
+    }
+    memcpy(&hdr, src->data_.data(), sizeof(hdr));
+    if (memcmp(hdr.magic, "IROB", 4) != 0 || hdr.version != 1 || hdr.width == 0 || hdr.height == 0)
+    {
+        errorOut = "Invalid object list file header: " + path;
+        return nullptr;
+    }
+
+    // 가변 길이 레코드 색인. 마지막 레코드가 잘렸으면 (녹화 중 비정상 종료) 거기서 멈춤.
+    size_t pos = sizeof(hdr);
+    while (pos + sizeof(ObjectFrameHeader) <= src->data_.size() &&
+           (hdr.frameCount == 0 || src->offsets_.size() < hdr.frameCount))
+    {
+        ObjectFrameHeader fh;
+        memcpy(&fh, src->data_.data() + pos, sizeof(fh));
+        size_t end = pos + sizeof(fh) + static_cast<size_t>(fh.objectCount) * sizeof(ObjectRecord);
+        if (end > src->data_.size()) break;
+        src->offsets_.push_back(pos);
+        pos = end;
+    }
+    if (src->offsets_.empty())
+    {
+        errorOut = "Object list file contains no frames: " + path;
+        return nullptr;
+    }
+
+    src->objects_.reserve(MAX_SOURCE_OBJECTS);
+    src->width_  = static_cast<int>(hdr.width);
+    src->height_ = static_cast<int>(hdr.height);
+    src->pacing_ = pacing;
+    src->loop_   = loop;
+
+    std::cout << "[Replay] " << path << ": " << src->offsets_.size() << " object frames, "
+              << src->width_ << "x" << src->height_
+              << (pacing == ReplayPacing::Realtime ? " (realtime)" : " (as fast as possible)")
+              << (loop ? " (loop)" : "") << std::endl;
+    return src;
+}
+
+bool ObjectReplaySource::nextFrame(SourceFrame& out)
+{
+    if (finished_) return false;
+
+    if (next_ >= offsets_.size())
+    {
+        if (!loop_)
+        {
+            finished_ = true;
+            std::cout << "[Replay] End of object list reached." << std::endl;
+            return false;
+        }
+        next_ = 0;
+    }
+
+    const unsigned char* rec = data_.data() + offsets_[next_];
+    ObjectFrameHeader fh;
+    memcpy(&fh, rec, sizeof(fh));
+
+    if (pacing_ == ReplayPacing::Realtime)
+    {
+        if (next_ == 0)
+        {
+            wallStart_ = std::chrono::steady_clock::now();
+            firstTsUs_ = fh.timestampUs;
+        }
+        uint64_t offsetUs = fh.timestampUs >= firstTsUs_ ? fh.timestampUs - firstTsUs_ : 0;
+        std::this_thread::sleep_until(wallStart_ + std::chrono::microseconds(offsetUs));
+    }
+
+    int count = std::min(static_cast<int>(fh.objectCount), MAX_SOURCE_OBJECTS);
+    objects_.clear();
+    const unsigned char* p = rec + sizeof(fh);
+    for (int i = 0; i < count; i++, p += sizeof(ObjectRecord))
+    {
+        ObjectRecord r;
+        memcpy(&r, p, sizeof(r));
+        objects_.push_back({ r.x, r.y, static_cast<int>(r.area) });
+    }
+
+    out.data        = nullptr;
+    out.objects     = objects_.data();
+    out.objectCount = count;
+    out.width       = width_;
+    out.height      = height_;
+    out.frameId     = fh.frameId;
+    out.timestamp   = static_cast<double>(fh.timestampUs) * 1e-6;
+    ++next_;
+    return true;
+}
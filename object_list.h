@@ -0,0 +1,131 @@
+#pragma once
+
+#include "blob_labeler.h"
+#include "frame_source.h"
+#include "replay_source.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ========== 객체 목록 녹화 파일 포맷 (.irobj) ==========
+// [ObjectFileHeader] + 프레임마다 ( [ObjectFrameHeader] + objectCount × [ObjectRecord] )
+// 프레임 레코드 길이가 가변이라 재생 시 한 번 훑어 오프셋 색인을 만든다. 모든 정수는 little-endian.
+// 좌표는 원본 카메라 픽셀 (렌즈 보정·호모그래피 전) — .irraw 와 같은 좌표계.
+#pragma pack(push, 1)
+struct ObjectFileHeader
+{
+    char     magic[4];      // "IROB"
+    uint32_t version;       // 1
+    uint32_t width;
+    uint32_t height;
+    uint32_t frameCount;    // 0 이면 파일 끝까지
+    uint32_t reserved[3];
+};
+
+struct ObjectFrameHeader
+{
+    uint64_t timestampUs;   // 원본 캡처 타임스탬프 (µs)
+    uint32_t frameId;
+    uint32_t objectCount;
+};
+
+struct ObjectRecord
+{
+    float    x;
+    float    y;
+    uint32_t area;
+};
+#pragma pack(pop)
+
+// 파일 앞 4바이트가 "IROB" 인지 (--replay 가 .irraw / .irobj 를 구분할 때 사용)
+bool isObjectListFile(const std::string& path);
+
+// ========== 객체 목록 기록기 ==========
+// FrameRecorder 와 같은 구조: 처리 스레드는 write() 에서 미리 할당된 블록 버퍼에 memcpy 만 하고,
+// 블록이 차면 인덱스를 링으로 넘긴다. 기록 스레드가 블록 단위로 fwrite 한다.
+// 빈 블록이 없으면 그 프레임은 버리고 (droppedFrames) 처리 스레드는 디스크를 기다리지 않는다.
+// 프레임당 객체는 MAX_SOURCE_OBJECTS 개까지 (넘는 검출은 기록하지 않음).
+class ObjectListWriter
+{
+public:
+    static constexpr int BLOCK_COUNT = 8;
+
+    // 실패 시 nullptr + errorOut
+    static std::unique_ptr<ObjectListWriter> open(const std::string& path, int width, int height,
+                                                  std::string& errorOut);
+    // 채우던 블록까지 모두 쓰고 닫음 (파이프라인 종료 시 처리 스레드가 멈춘 뒤)
+    ~ObjectListWriter();
+
+    // 처리 스레드 전용. blobs: FrameResult::blobs (프레임 좌표 중심점 + 면적, 호스트 검출 / 카메라 객체 공통)
+    void write(uint32_t frameId, double timestamp, const std::vector<Blob>& blobs);
+
+    uint32_t framesWritten() const { return frames_.load(std::memory_order_relaxed); }
+    uint32_t droppedFrames() const { return drops_.load(std::memory_order_relaxed); }
+
+private:
+    ObjectListWriter() = default;
+
+    void writerLoop();
+
+    FILE*                                   file_ = nullptr;
+    std::vector<std::vector<uint8_t>>       blocks_;
+    std::vector<size_t>                     used_;          // 블록별 채운 바이트
+    SpscRing<int, BLOCK_COUNT>              freeBlocks_;    // 기록 → 처리
+    SpscRing<int, BLOCK_COUNT>              filled_;        // 처리 → 기록
+    int                                     current_ = -1;  // 처리 스레드 전용: 채우는 중인 블록
+
+    std::thread             writer_;
+    std::mutex              wakeMutex_;
+    std::condition_variable wakeCv_;
+    std::atomic<bool>       stopping_{false};
+    bool                    writeFailed_ = false;           // 기록 스레드 전용
+
+    std::atomic<uint32_t> frames_{0};
+    std::atomic<uint32_t> drops_{0};
+};
+
+// ========== 객체 목록 재생 프레임 소스 ==========
+// 카메라 객체 모드와 같은 경로 (data == nullptr, objects 만) 로 녹화 객체 목록을 재생한다.
+// 객체 목록은 작아서 (120fps × 객체 20개 ≈ 30KB/s) 파일 전체를 메모리로 읽는다.
+class ObjectReplaySource : public IFrameSource
+{
+public:
+    static std::unique_ptr<ObjectReplaySource> open(const std::string& path,
+                                                    ReplayPacing pacing,
+                                                    bool loop,
+                                                    std::string& errorOut);
+
+    int  width()  const override { return width_; }
+    int  height() const override { return height_; }
+    bool nextFrame(SourceFrame& out) override;
+    bool finished() const override { return finished_; }
+    bool objectMode() const override { return true; }
+
+    uint32_t frameCount() const { return static_cast<uint32_t>(offsets_.size()); }
+
+private:
+    ObjectReplaySource() = default;
+
+    std::vector<unsigned char> data_;
+    std::vector<size_t>        offsets_;    // 프레임 레코드 시작 위치
+    std::vector<SourceObject>  objects_;    // 현재 프레임 객체 (재사용)
+    int width_  = 0;
+    int height_ = 0;
+
+    ReplayPacing pacing_   = ReplayPacing::Realtime;
+    bool         loop_     = false;
+    bool         finished_ = false;
+    uint32_t     next_     = 0;
+
+    std::chrono::steady_clock::time_point wallStart_;
+    uint64_t                              firstTsUs_ = 0;
+};
@@ -0,0 +1,196 @@
+#include "optitrack_source.h"
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+using namespace CameraLibrary;
+
+// Camera SDK 는 프로세스 전역. 카메라 소스들이 공유하고, 마지막 소스가 해제될 때 한 번만 종료.
+struct CameraSdkSession
+{
+    ~CameraSdkSession() { CameraManager::X().Shutdown(); }
+};
+
+// ─────────────────────────────────────────────────────────
+
+std::vector<std::unique_ptr<OptiTrackFrameSource>> OptiTrackFrameSource::openAll(
+    int exposure, int maxCameras, bool objectMode, int objectThreshold, std::string& errorOut)
+{
+    std::vector<std::unique_ptr<OptiTrackFrameSource>> sources;
+
+    std::cout << "Initializing Camera SDK..." << std::endl;
+    CameraManager::X().WaitForInitialization();
+
+    if (!CameraManager::X().AreCamerasInitialized())
+    {
+        std::cerr << "Failed to initialize cameras." << std::endl;
+        errorOut = "Failed to initialize Camera SDK.";
+        return sources;
+    }
+    std::cout << "Camera SDK initialized successfully." << std::endl;
+    auto sdk = std::make_shared<CameraSdkSession>();
+
+    CameraList list;
+    std::cout << "Number of cameras detected: " << list.Count() << std::endl;
+
+    if (list.Count() == 0)
+    {
+        std::cerr << "No cameras found!" << std::endl;
+        errorOut = "No OptiTrack cameras found.";
+        return sources;
+    }
+
+    for (int i = 0; i < list.Count(); i++)
+    {
+        std::cout << "Camera " << i << ": " << list[i].Name() << std::endl;
+        std::cout << "  UID: " << list[i].UID() << std::endl;
+        std::cout << std::dec; // UID() sets std::hex internally; reset to decimal
+        std::cout << "  Initial State: " << list[i].State() << std::endl;
+    }
+
+    int wanted = std::min(maxCameras, list.Count());
+    if (wanted < maxCameras)
+        std::cerr << "camera_count=" << maxCameras << " but only " << list.Count()
+                  << " camera(s) connected." << std::endl;
+
+    std::cout << "Waiting for " << wanted << " camera(s) to fully initialize..." << std::endl;
+    bool camerasReady = false;
+    for (int i = 0; i < 100 && !camerasReady; i++) // 최대 10초 대기
+    {
+        CameraList cur;
+        camerasReady = cur.Count() >= wanted;
+        for (int c = 0; c < wanted && camerasReady; c++)
+            camerasReady = cur[c].State() == 6;
+        if (!camerasReady)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    if (!camerasReady)
+    {
+        std::cerr << "Camera failed to initialize within 10 seconds." << std::endl;
+        errorOut = "Camera initialization timeout.";
+        return sources;
+    }
+    std::cout << "Camera(s) initialized!" << std::endl;
+
+    for (int c = 0; c < wanted; c++)
+    {
+        std::cout << "Getting camera with UID: " << list[c].UID() << std::endl;
+        std::cout << std::dec;
+        std::shared_ptr<Camera> camera = CameraManager::X().GetCamera(list[c].UID());
+
+        if (!camera)
+        {
+            std::cerr << "Failed to get camera pointer for camera " << c << "." << std::endl;
+            errorOut = "Failed to get camera pointer.";
+            sources.clear();
+            return sources;
+        }
+
+        std::cout << "Camera " << c + 1 << " Serial: " << camera->Serial() << std::endl;
+        std::cout << "Camera " << c + 1 << " Name: "   << camera->Name()   << std::endl;
+        std::cout << "Camera " << c + 1 << " Resolution: " << camera->Width() << "x" << camera->Height() << std::endl;
+
+        // ========== 카메라 설정 ==========
+        if (objectMode)
+        {
+            // 카메라 FPGA 가 임계값 분할 + 무게중심 계산 → 프레임마다 객체 목록만 전송
+            camera->SetVideoType(Core::ObjectMode);
+            camera->SetThreshold(objectThreshold);
+        }
+        else
+        {
+            camera->SetVideoType(Core::GrayscaleMode);
+        }
+        camera->SetExposure(exposure);
+        camera->SetIntensity(0);
+        camera->Start();
+        std::cout << "Camera " << c + 1 << " started ("
+                  << (objectMode ? "Object, threshold " + std::to_string(objectThreshold) : std::string("Grayscale"))
+                  << ", exposure " << exposure << ", IR illumination off)." << std::endl;
+
+        sources.emplace_back(new OptiTrackFrameSource(sdk, std::move(camera), objectMode));
+    }
+    return sources;
+}
+
+// ─────────────────────────────────────────────────────────
+
+OptiTrackFrameSource::OptiTrackFrameSource(std::shared_ptr<CameraSdkSession> sdk,
+                                           std::shared_ptr<Camera> camera,
+                                           bool objectMode)
+    : sdk_(std::move(sdk)), camera_(std::move(camera)), objectMode_(objectMode)
+{
+    width_  = camera_->Width();
+    height_ = camera_->Height();
+    objects_.reserve(MAX_SOURCE_OBJECTS);
+}
+
+OptiTrackFrameSource::~OptiTrackFrameSource()
+{
+    current_.reset();
+    camera_.reset();
+    sdk_.reset();   // 마지막 카메라면 여기서 Camera SDK 종료
+}
+
+bool OptiTrackFrameSource::nextFrame(SourceFrame& out)
+{
+    std::shared_ptr<const Frame> frame = camera_->LatestFrame();
+    if (!frame) return false;
+
+    if (frame->IsGrayscale())
+    {
+        const unsigned char* data = frame->GrayscaleData(*camera_);
+        if (!data) return false;
+
+        // 요청한 미리보기 프레임을 받았으면 바로 객체 모드로 복귀
+        if (grayscaleActive_)
+        {
+            camera_->SetVideoType(Core::ObjectMode);
+            grayscaleActive_ = false;
+        }
+        current_      = std::move(frame);
+        out.data      = data;
+    }
+    else
+    {
+        if (!objectMode_) return false;
+
+        if (!grayscaleActive_ && previewRequested_.exchange(false))
+        {
+            camera_->SetVideoType(Core::GrayscaleMode);
+            grayscaleActive_ = true;
+        }
+
+        int count = std::min(frame->ObjectCount(), MAX_SOURCE_OBJECTS);
+        objects_.clear();
+        for (int i = 0; i < count; i++)
+        {
+            const cObject* obj = frame->Object(i);
+            objects_.push_back({ obj->X(), obj->Y(), obj->Area() });
+        }
+        current_        = std::move(frame);
+        out.data        = nullptr;
+        out.objects     = objects_.data();
+        out.objectCount = count;
+    }
+
+    out.width     = width_;
+    out.height    = height_;
+    out.frameId   = static_cast<uint32_t>(current_->FrameID());
+    out.timestamp = current_->TimeStamp();
+    return true;
+}
+
+bool OptiTrackFrameSource::requestGrayscale()
+{
+    if (!objectMode_) return false;
+    previewRequested_.store(true);
+    return true;
+}
+
+void OptiTrackFrameSource::setExposure(int exposure)
+{
+    camera_->SetExposure(exposure);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "frame_source.h"
+#include "cameralibrary.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct CameraSdkSession;
+
+// ========== OptiTrack Flex 13 카메라 프레임 소스 ==========
+class OptiTrackFrameSource : public IFrameSource
+{
+public:
+    // Camera SDK 초기화 → 연결된 카메라 중 앞에서부터 최대 maxCameras 대 대기/획득 → Grayscale 모드로 시작.
+    // objectMode 면 Object 모드로 시작해 카메라가 objectThreshold 로 분할한 객체 목록만 받는다
+    // (USB 로 영상 전송 없음). 하나도 못 열면 빈 벡터 반환, errorOut 에 사용자 표시용 메시지 기록.
+    // 카메라 순서는 CameraList 순서 (setting.cfg 의 카메라 번호와 대응).
+    static std::vector<std::unique_ptr<OptiTrackFrameSource>> openAll(int exposure, int maxCameras,
+                                                                      bool objectMode, int objectThreshold,
+                                                                      std::string& errorOut);
+
+    ~OptiTrackFrameSource() override;
+
+    int  width()  const override { return width_; }
+    int  height() const override { return height_; }
+    bool nextFrame(SourceFrame& out) override;
+    void setExposure(int exposure) override;
+    bool objectMode() const override { return objectMode_; }
+
+    // 다음 프레임 하나를 Grayscale 모드로 받은 뒤 Object 모드로 복귀 (모드 전환에 1~2 프레임 소요)
+    bool requestGrayscale() override;
+
+private:
+    OptiTrackFrameSource(std::shared_ptr<CameraSdkSession> sdk,
+                         std::shared_ptr<CameraLibrary::Camera> camera,
+                         bool objectMode);
+
+    std::shared_ptr<CameraSdkSession>           sdk_;       // 마지막 소스가 해제될 때 SDK Shutdown
+    std::shared_ptr<CameraLibrary::Camera>      camera_;
+    std::shared_ptr<const CameraLibrary::Frame> current_;   // data 수명 유지용
+    int width_  = 0;
+    int height_ = 0;
+
+    // 객체 모드 (캡처 스레드 전용, previewRequested_ 만 다른 스레드에서 세움)
+    bool                      objectMode_      = false;
+    bool                      grayscaleActive_ = false;    // 미리보기용으로 Grayscale 전환 중
+    std::atomic<bool>         previewRequested_{false};
+    std::vector<SourceObject> objects_;
+};
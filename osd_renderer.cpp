@@ -17,7 +17,7 @@ void renderOSD(cv::Mat& image, const OSDState& state)
     // ===== 상단 OSD: 단축키 안내 =====
     {
         bool showProgress = (state.selectedPointCount > 0 && !state.homographyReady);
-        int  boxH         = showProgress ? 138 : 120;
+        int  boxH         = showProgress ? 192 : 174;
 
         cv::Mat overlay = image.clone();
         cv::rectangle(overlay, cv::Point(4, 4), cv::Point(252, boxH),
@@ -36,11 +36,25 @@ void renderOSD(cv::Mat& image, const OSDState& state)
         putKey(image, "[P] Settings",                    cv::Scalar(200,200,200), 76);
         putKey(image, "[S] Save Config",                 cv::Scalar(200,200,200), 94);
         putKey(image, "[L-Click] Select Corner (4pts)",  cv::Scalar(200,200,200), 112);
+        putKey(image, "[C] Auto Calibrate (IR grid)",    cv::Scalar(200,200,200), 130);
+
+        std::string bgLabel = "[B] Learn Background";
+        if (state.backgroundPixels > 0)
+            bgLabel += " (" + std::to_string(state.backgroundPixels) + " px)";
+        putKey(image, bgLabel,                           cv::Scalar(200,200,200), 148);
+
+        // 녹화 중: "[V] REC 1234 fr 56MB d0" (d = 기록 버퍼가 모자라 녹화에서 빠진 프레임)
+        std::string recLabel = state.recording
+                             ? "[V] REC " + std::to_string(state.recordFrames) + " fr " +
+                               std::to_string(state.recordMB) + "MB d" + std::to_string(state.recordDrops)
+                             : std::string("[V] Record Raw Frames");
+        putKey(image, recLabel,
+               state.recording ? cv::Scalar(60, 60, 255) : cv::Scalar(200, 200, 200), 166);
 
         if (showProgress)
             putKey(image,
                    "  -> " + std::to_string(state.selectedPointCount) + "/4 pts selected",
-                   cv::Scalar(255, 190, 60), 130);
+                   cv::Scalar(255, 190, 60), 184);
     }
 
     // ===== 하단 OSD: 전송 상태 및 검출 포인트 수 =====
@@ -55,6 +69,62 @@ void renderOSD(cv::Mat& image, const OSDState& state)
                     cv::Point(8, image.rows - 8),
                     cv::FONT_HERSHEY_SIMPLEX, 0.50, statusColor, 1, cv::LINE_AA);
 
+        std::string allocStr = "Alloc/frame: " + std::to_string(state.frameAllocations);
+        cv::putText(image, allocStr,
+                    cv::Point(image.cols / 2 - 60, image.rows - 8),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.45,
+                    state.frameAllocations == 0 ? cv::Scalar(120, 120, 120) : cv::Scalar(60, 120, 255),
+                    1, cv::LINE_AA);
+
+        // 파이프라인 큐 깊이 / 드롭 수 (상태 줄 바로 위)
+        std::string queueStr = "Queue cap/disp: " + std::to_string(state.captureQueue) + "/" +
+                               std::to_string(state.displayQueue) +
+                               "  Drop: " + std::to_string(state.droppedFrames) + "/" +
+                               std::to_string(state.displayDrops);
+        cv::putText(image, queueStr,
+                    cv::Point(8, image.rows - 28),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.42, cv::Scalar(160, 160, 160), 1, cv::LINE_AA);
+
+        // 종단 간 지연 (최근 1초, 전송 중일 때만)
+        if (state.continuousSend && state.latencyP99Us > 0)
+        {
+            std::string latStr = "Latency p50/95/99: " + std::to_string(state.latencyP50Us) + "/" +
+                                 std::to_string(state.latencyP95Us) + "/" +
+                                 std::to_string(state.latencyP99Us) + "us  (p99 det " +
+                                 std::to_string(state.detectP99Us) + " / hand " +
+                                 std::to_string(state.handoffP99Us) + " / send " +
+                                 std::to_string(state.sendP99Us) + ")";
+            cv::putText(image, latStr,
+                        cv::Point(8, image.rows - 46),
+                        cv::FONT_HERSHEY_SIMPLEX, 0.42, cv::Scalar(160, 200, 160), 1, cv::LINE_AA);
+        }
+
+        // 다중 카메라: "Cam 1* 120fps d0 | Cam 2 118fps d3" (* = 화면에 보이는 카메라)
+        if (state.cameraCount > 1)
+        {
+            std::string camStr;
+            for (int c = 0; c < state.cameraCount; c++)
+            {
+                if (c > 0) camStr += " | ";
+                camStr += "Cam " + std::to_string(c + 1) + (c == state.activeCamera ? "* " : " ") +
+                          std::to_string(state.cameraFps[c]) + "fps d" + std::to_string(state.cameraDrops[c]);
+            }
+            cv::putText(image, camStr,
+                        cv::Point(8, image.rows - 64),
+                        cv::FONT_HERSHEY_SIMPLEX, 0.42, cv::Scalar(200, 180, 120), 1, cv::LINE_AA);
+        }
+
+        // 임계값 / 노출: "Thr 187A  Exp 3200A  bg 41 pk 228" (A = 자동 조절)
+        {
+            std::string lvlStr = "Thr " + std::to_string(state.threshold) + (state.autoThreshold ? "A" : "") +
+                                 "  Exp " + std::to_string(state.exposure) + (state.autoExposure ? "A" : "");
+            if (state.autoThreshold || state.autoExposure)
+                lvlStr += "  bg " + std::to_string(state.background) + " pk " + std::to_string(state.peak);
+            cv::putText(image, lvlStr,
+                        cv::Point(image.cols - 250, image.rows - 28),
+                        cv::FONT_HERSHEY_SIMPLEX, 0.42, cv::Scalar(160, 160, 160), 1, cv::LINE_AA);
+        }
+
         if (state.displayCount > 0)
         {
             std::string ptStr = "Detected: " + std::to_string(state.displayCount) + " pt(s)";
@@ -74,4 +144,15 @@ void renderOSD(cv::Mat& image, const OSDState& state)
         cv::putText(image, msg, cv::Point(textX, 35),
                     cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(80, 255, 160), 2, cv::LINE_AA);
     }
+
+    // ===== 중앙 상단: 배경 학습 중 안내 =====
+    if (state.learningBackground)
+    {
+        const std::string msg = "Learning background - keep targets out";
+        int textX = image.cols / 2 - 200;
+        cv::putText(image, msg, cv::Point(textX + 1, 66),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(0, 0, 0), 3, cv::LINE_AA);
+        cv::putText(image, msg, cv::Point(textX, 65),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(80, 200, 255), 2, cv::LINE_AA);
+    }
 }
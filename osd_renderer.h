@@ -2,6 +2,8 @@
 
 #include <opencv2/opencv.hpp>
 
+#include "frame_source.h"
+
 // ========== OSD 렌더링에 필요한 상태 ==========
 struct OSDState
 {
@@ -12,6 +14,45 @@ struct OSDState
                          //                     homographyReady  → inBoundCenters.size()
     bool configSaved;    // true 이면 화면 중앙에 "Config Saved!" 2초간 표시
     int  udpActualFps;   // 실제 UDP 전송 FPS (sender.actualFps())
+    // 종단 간 지연 (acquire → sendto) 최근 1초 분위수 (µs, LatencyTrace::window)
+    int  latencyP50Us = 0;
+    int  latencyP95Us = 0;
+    int  latencyP99Us = 0;
+    // 단계별 p99 (µs): acquire → detect / detect → 전송 스레드 전달 / 전달 → sendto
+    int  detectP99Us  = 0;
+    int  handoffP99Us = 0;
+    int  sendP99Us    = 0;
+    int  frameAllocations = 0; // 직전 프레임의 FrameProcessor 버퍼 할당 수 (steady-state = 0)
+
+    // 파이프라인 단계별 상태 (TrackingPipeline::stats())
+    int  captureQueue  = 0;    // 캡처 → 처리 대기 프레임 수
+    int  displayQueue  = 0;    // 처리 → 표시 대기 프레임 수
+    long droppedFrames = 0;    // 캡처 단계 + drain-to-latest 로 버린 누적 프레임
+    long displayDrops  = 0;    // 표시가 밀려 건너뛴 누적 프레임
+
+    // 다중 카메라: 카메라별 처리 FPS / 누적 드롭 (cameraCount > 1 일 때만 표시)
+    int  cameraCount  = 1;
+    int  activeCamera = 0;     // 화면에 보이는 카메라 (0부터)
+    int  cameraFps[MAX_CAMERAS]   = {};
+    long cameraDrops[MAX_CAMERAS] = {};
+
+    // 표시 중인 카메라의 임계값 / 노출 (자동 조절이면 배경·점 밝기도)
+    int  threshold     = 0;
+    int  exposure      = 0;
+    bool autoThreshold = false;
+    bool autoExposure  = false;
+    int  background    = 0;
+    int  peak          = 0;
+
+    // 표시 중인 카메라의 학습 배경 마스크
+    bool learningBackground = false;   // true 이면 화면 중앙에 학습 중 안내
+    long backgroundPixels   = 0;       // 억제 중인 마스크 픽셀 수 (0 = 마스크 없음 / 꺼짐)
+
+    // 원시 프레임 녹화 (모든 카메라 합계)
+    bool recording    = false;
+    long recordFrames = 0;
+    long recordDrops  = 0;
+    long recordMB     = 0;
 };
 
 void renderOSD(cv::Mat& image, const OSDState& state);
@@ -0,0 +1,217 @@
+#include "packet_format.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+static const uint8_t MAGIC[4] = { 'I', 'R', 'T', 'P' };
+
+// ─────────────────────────────────────────────────────────
+//  이름
+// ─────────────────────────────────────────────────────────
+
+const char* packetFormatName(PacketFormat f)
+{
+    switch (f)
+    {
+    case PacketFormat::Text:   return "text";
+    case PacketFormat::Binary: return "binary";
+    }
+    return "unknown";
+}
+
+bool parsePacketFormat(const char* name, PacketFormat& out)
+{
+    static const PacketFormat all[] = { PacketFormat::Text, PacketFormat::Binary };
+    for (PacketFormat f : all)
+    {
+        if (strcmp(name, packetFormatName(f)) == 0) { out = f; return true; }
+    }
+    return false;
+}
+
+const char* udpSendModeName(UdpSendMode m)
+{
+    switch (m)
+    {
+    case UdpSendMode::Fixed: return "fixed";
+    case UdpSendMode::Event: return "event";
+    }
+    return "unknown";
+}
+
+bool parseUdpSendMode(const char* name, UdpSendMode& out)
+{
+    static const UdpSendMode all[] = { UdpSendMode::Fixed, UdpSendMode::Event };
+    for (UdpSendMode m : all)
+    {
+        if (strcmp(name, udpSendModeName(m)) == 0) { out = m; return true; }
+    }
+    return false;
+}
+
+// ─────────────────────────────────────────────────────────
+//  little-endian 읽기/쓰기 (호스트 엔디안과 무관)
+// ─────────────────────────────────────────────────────────
+
+static inline uint8_t* putU16(uint8_t* p, uint16_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    return p + 2;
+}
+
+static inline uint8_t* putU32(uint8_t* p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = static_cast<uint8_t>(v >> (8 * i));
+    return p + 4;
+}
+
+static inline uint8_t* putU64(uint8_t* p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) p[i] = static_cast<uint8_t>(v >> (8 * i));
+    return p + 8;
+}
+
+static inline uint8_t* putF32(uint8_t* p, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, 4);
+    return putU32(p, v);
+}
+
+static inline uint16_t getU16(const uint8_t* p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t getU32(const uint8_t* p)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(p[i]) << (8 * i);
+    return v;
+}
+
+static inline uint64_t getU64(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+
+static inline float getF32(const uint8_t* p)
+{
+    uint32_t v = getU32(p);
+    float f;
+    memcpy(&f, &v, 4);
+    return f;
+}
+
+// ─────────────────────────────────────────────────────────
+//  Public API
+// ─────────────────────────────────────────────────────────
+
+int formatTextPacket(std::string& out, const float* xy, int count, int decimals,
+                     const uint32_t* ids)
+{
+    out.clear();
+    char buf[64];
+    for (int i = 0; i < count; i++)
+    {
+        if (i > 0) out += ';';
+        // decimals > 0: sub-pixel 좌표 그대로 전송. 기존 수신측(stoi)은 소수점 앞 정수부만 읽으므로 호환됨.
+        int n = (decimals > 0)
+            ? snprintf(buf, sizeof(buf), "%.*f,%.*f", decimals, xy[2 * i], decimals, xy[2 * i + 1])
+            : snprintf(buf, sizeof(buf), "%d,%d",
+                       static_cast<int>(xy[2 * i]), static_cast<int>(xy[2 * i + 1]));
+        out.append(buf, static_cast<size_t>(n));
+        if (ids)
+        {
+            n = snprintf(buf, sizeof(buf), ",%u", static_cast<unsigned>(ids[i]));
+            out.append(buf, static_cast<size_t>(n));
+        }
+    }
+    return static_cast<int>(out.length());
+}
+
+size_t binaryPacketSize(int count, bool withArea, bool withId)
+{
+    return PACKET_HEADER_SIZE + static_cast<size_t>(count) * (8 + (withArea ? 4 : 0) + (withId ? 4 : 0));
+}
+
+size_t encodeBinaryPacket(uint8_t*            buffer,
+                          size_t              capacity,
+                          const PacketHeader& header,
+                          const float*        xy,
+                          const uint32_t*     areas,
+                          const uint32_t*     ids)
+{
+    bool   withArea = (header.flags & PACKET_FLAG_AREA) != 0 && areas != nullptr;
+    bool   withId   = (header.flags & PACKET_FLAG_ID)   != 0 && ids   != nullptr;
+    size_t size     = binaryPacketSize(header.count, withArea, withId);
+    if (size > capacity) return 0;
+
+    uint8_t flags = header.flags;
+    if (!withArea) flags = static_cast<uint8_t>(flags & ~PACKET_FLAG_AREA);
+    if (!withId)   flags = static_cast<uint8_t>(flags & ~PACKET_FLAG_ID);
+
+    uint8_t* p = buffer;
+    memcpy(p, MAGIC, 4); p += 4;
+    *p++ = header.version;
+    *p++ = flags;
+    p = putU16(p, header.count);
+    p = putU32(p, header.sequence);
+    p = putU32(p, header.frameId);
+    p = putU64(p, header.captureTimeUs);
+
+    for (int i = 0; i < header.count; i++)
+    {
+        p = putF32(p, xy[2 * i]);
+        p = putF32(p, xy[2 * i + 1]);
+        if (withArea) p = putU32(p, areas[i]);
+        if (withId)   p = putU32(p, ids[i]);
+    }
+    return size;
+}
+
+bool isBinaryPacket(const uint8_t* data, size_t length)
+{
+    return length >= 4 && memcmp(data, MAGIC, 4) == 0;
+}
+
+bool decodeBinaryPacket(const uint8_t*            data,
+                        size_t                    length,
+                        PacketHeader&             header,
+                        std::vector<PacketPoint>& out)
+{
+    out.clear();
+    if (length < PACKET_HEADER_SIZE || !isBinaryPacket(data, length)) return false;
+
+    header.version       = data[4];
+    header.flags         = data[5];
+    header.count         = getU16(data + 6);
+    header.sequence      = getU32(data + 8);
+    header.frameId       = getU32(data + 12);
+    header.captureTimeUs = getU64(data + 16);
+    if (header.version != PACKET_VERSION) return false;
+
+    bool withArea = (header.flags & PACKET_FLAG_AREA) != 0;
+    bool withId   = (header.flags & PACKET_FLAG_ID)   != 0;
+    if (length < binaryPacketSize(header.count, withArea, withId)) return false;
+
+    const uint8_t* p = data + PACKET_HEADER_SIZE;
+    out.resize(header.count);
+    for (PacketPoint& pt : out)
+    {
+        pt.x = getF32(p);     p += 4;
+        pt.y = getF32(p);     p += 4;
+        if (withArea) { pt.area = getU32(p); p += 4; }
+        if (withId)   { pt.id   = getU32(p); p += 4; }
+    }
+    return true;
+}
+
+uint64_t wallClockMicros()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ========== UDP 패킷 포맷 선택 ==========
+enum class PacketFormat
+{
+    Text   = 0,     // 기존 "x1,y1;x2,y2;..." (기본값, 기존 수신측 호환)
+    Binary = 1      // IRTP 바이너리 (아래 레이아웃)
+};
+
+const char* packetFormatName(PacketFormat f);
+bool        parsePacketFormat(const char* name, PacketFormat& out);
+
+// ========== UDP 전송 방식 ==========
+enum class UdpSendMode
+{
+    Fixed = 0,      // 1/fps 간격으로 최신 좌표 재전송 (기존 동작)
+    Event = 1       // 새 검출 결과가 오면 즉시 전송 (+ 최소 간격, keepalive 재전송)
+};
+
+const char* udpSendModeName(UdpSendMode m);
+bool        parseUdpSendMode(const char* name, UdpSendMode& out);
+
+// ========== 텍스트 패킷 ==========
+// xy (count × 2개) → out = "x1,y1;x2,y2;..." (out 의 capacity 재사용).
+// decimals 0 = 기존 정수 포맷, 1~3 = sub-pixel 좌표.
+// ids 가 있으면 "x1,y1,id1;..." — 기존 수신측은 두 번째 ',' 뒤를 무시하므로 호환됨.
+// 반환: 패킷 길이
+int formatTextPacket(std::string& out, const float* xy, int count, int decimals,
+                     const uint32_t* ids = nullptr);
+
+// ========== IRTP 바이너리 패킷 (version 1) ==========
+// 모든 정수/실수는 little-endian.
+//
+//   offset  size  field
+//   0       4     magic "IRTP"
+//   4       1     version (= 1)
+//   5       1     flags (PACKET_FLAG_*)
+//   6       2     point count
+//   8       4     sequence number (전송 스레드가 패킷마다 +1 → 수신측 손실/순서 뒤바뀜 검출)
+//   12      4     frame id (카메라/녹화 파일 프레임 번호, 같은 프레임 재전송이면 동일)
+//   16      8     capture timestamp (µs, system_clock epoch — 호스트 간 비교 시 시계 동기 필요)
+//   24      ...   point × count: float32 x, float32 y [, uint32 area (PACKET_FLAG_AREA)]
+//                                  [, uint32 track id (PACKET_FLAG_ID)]
+constexpr uint8_t PACKET_VERSION     = 1;
+constexpr size_t  PACKET_HEADER_SIZE = 24;
+constexpr uint8_t PACKET_FLAG_AREA   = 0x01;   // 좌표마다 블롭 면적(px) 포함
+constexpr uint8_t PACKET_FLAG_ID     = 0x02;   // 좌표마다 추적 ID 포함 (프레임 사이 같은 점 = 같은 ID)
+constexpr size_t  PACKET_MAX_POINT_SIZE = 16;  // x, y, area, id
+
+struct PacketHeader
+{
+    uint8_t  version       = PACKET_VERSION;
+    uint8_t  flags         = 0;
+    uint16_t count         = 0;
+    uint32_t sequence      = 0;
+    uint32_t frameId       = 0;
+    uint64_t captureTimeUs = 0;
+};
+
+struct PacketPoint
+{
+    float    x    = 0.f;
+    float    y    = 0.f;
+    uint32_t area = 0;      // PACKET_FLAG_AREA 가 없으면 0
+    uint32_t id   = 0;      // PACKET_FLAG_ID 가 없으면 0
+};
+
+// header.count 개 좌표를 담는 데 필요한 바이트 수
+size_t binaryPacketSize(int count, bool withArea, bool withId = false);
+
+// xy: x0,y0,x1,y1,... (header.count × 2개). areas 는 PACKET_FLAG_AREA, ids 는 PACKET_FLAG_ID 일 때만 사용
+// (플래그가 있어도 배열이 nullptr 이면 해당 필드를 빼고 플래그도 지움).
+// 반환: 쓴 바이트 수 (capacity 부족이면 0)
+size_t encodeBinaryPacket(uint8_t*            buffer,
+                          size_t              capacity,
+                          const PacketHeader& header,
+                          const float*        xy,
+                          const uint32_t*     areas,
+                          const uint32_t*     ids = nullptr);
+
+// magic 이 "IRTP" 이면 true (텍스트 패킷과 구분)
+bool isBinaryPacket(const uint8_t* data, size_t length);
+
+// 길이/버전/개수 검증 후 out 을 채움. 잘못된 패킷이면 false.
+bool decodeBinaryPacket(const uint8_t*            data,
+                        size_t                    length,
+                        PacketHeader&             header,
+                        std::vector<PacketPoint>& out);
+
+// 현재 시각 (µs, system_clock epoch) — capture timestamp / latency 계산용
+uint64_t wallClockMicros();
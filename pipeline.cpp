@@ -0,0 +1,363 @@
+#include "pipeline.h"
+#include "packet_format.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+TrackingPipeline::TrackingPipeline(IFrameSource& source, PointMerger& merger, int camera)
+    : source_(source), merger_(merger), camera_(camera)
+{
+    size_t frameBytes = static_cast<size_t>(source.width()) * source.height();
+
+    capturePool_.resize(CAPTURE_SLOTS);
+    for (int i = 0; i < CAPTURE_SLOTS; i++)
+    {
+        capturePool_[i].pixels.resize(frameBytes);
+        capturePool_[i].objects.reserve(MAX_SOURCE_OBJECTS);
+        captureFree_.push(i);
+    }
+
+    displayPool_.resize(DISPLAY_SLOTS);
+    for (int i = 0; i < DISPLAY_SLOTS; i++)
+    {
+        displayPool_[i].pixels.resize(frameBytes);
+        displayPool_[i].objects.reserve(MAX_SOURCE_OBJECTS);
+        displayFree_.push(i);
+    }
+}
+
+TrackingPipeline::~TrackingPipeline()
+{
+    stop();
+}
+
+void TrackingPipeline::start(bool withDisplay)
+{
+    if (running_.load()) return;
+    withDisplay_ = withDisplay;
+    running_.store(true);
+    captureThread_ = std::thread(&TrackingPipeline::captureLoop, this);
+    processThread_ = std::thread(&TrackingPipeline::processLoop, this);
+    std::cout << "[Pipeline] Camera " << camera_ + 1 << " started (capture/process threads"
+              << (withDisplay ? " + display" : ", headless") << ")." << std::endl;
+}
+
+void TrackingPipeline::stop()
+{
+    if (!running_.load()) return;
+    running_.store(false);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+    }
+    wakeCv_.notify_one();
+    if (captureThread_.joinable()) captureThread_.join();
+    if (processThread_.joinable()) processThread_.join();
+    objectWriter_.reset();
+    recorder_.stop();
+    std::cout << "[Pipeline] Camera " << camera_ + 1 << " stopped. Drops: capture=" << captureDrops_.load()
+              << " stale=" << staleDrops_.load()
+              << " display=" << displayDrops_.load() << std::endl;
+}
+
+// ─────────────────────────────────────────────────────────
+//  설정 게시 / 적용
+// ─────────────────────────────────────────────────────────
+
+// matrix 는 copyTo 로 깊은 복사 (GUI 스레드의 Mat 과 버퍼를 공유하지 않음)
+void TrackingPipeline::copyConfig(ConfigSnapshot& dst, const HomographyState& hom,
+                                  const AppSettings& settings, const BackgroundMask& background)
+{
+    dst.hom.selectedPoints = hom.selectedPoints;
+    hom.matrix.copyTo(dst.hom.matrix);
+    dst.hom.ready  = hom.ready;
+    dst.settings   = settings;
+    dst.background = background;
+}
+
+void TrackingPipeline::publishConfig(const HomographyState& hom, const AppSettings& settings,
+                                     const BackgroundMask& background)
+{
+    std::lock_guard<std::mutex> lock(configMutex_);
+    copyConfig(published_, hom, settings, background);
+    configVersion_.fetch_add(1, std::memory_order_release);
+}
+
+void TrackingPipeline::refreshConfig()
+{
+    if (configVersion_.load(std::memory_order_acquire) == appliedVersion_) return;
+
+    std::lock_guard<std::mutex> lock(configMutex_);
+    // 코너나 타깃 해상도가 바뀌면 타깃 좌표계가 달라지므로 기존 트랙은 버림
+    if (published_.hom.selectedPoints != config_.hom.selectedPoints ||
+        published_.hom.ready != config_.hom.ready ||
+        published_.settings.targetWidth  != config_.settings.targetWidth ||
+        published_.settings.targetHeight != config_.settings.targetHeight)
+        merger_.resetTracks();
+    copyConfig(config_, published_.hom, published_.settings, published_.background);
+    appliedVersion_ = configVersion_.load(std::memory_order_relaxed);
+
+    // 자동 조절 설정이나 기준 노출이 바뀐 경우에만 컨트롤러 초기화
+    levels_.configure(config_.settings.levels, config_.settings.exposure);
+    if (config_.settings.levels.autoExposure && levels_.exposure() != config_.settings.exposure)
+        pendingExposure_.store(levels_.exposure());     // 시작 노출이 exposure_min~max 밖이면 맞춰 둠
+    levelThreshold_.store(levels_.threshold(), std::memory_order_relaxed);
+    levelExposure_.store(levels_.exposure(), std::memory_order_relaxed);
+}
+
+// ─────────────────────────────────────────────────────────
+//  캡처 스레드
+// ─────────────────────────────────────────────────────────
+
+void TrackingPipeline::captureLoop()
+{
+    while (running_.load())
+    {
+        int exposure = pendingExposure_.exchange(-1);
+        if (exposure >= 0)
+        {
+            source_.setExposure(exposure);
+            std::cout << "[Pipeline] Exposure applied: " << exposure << std::endl;
+        }
+
+        SourceFrame frame;
+        if (!source_.nextFrame(frame))
+        {
+            if (source_.finished()) sourceFinished_.store(true);
+            std::this_thread::yield();
+            continue;
+        }
+        uint64_t captureTimeUs = wallClockMicros();
+        int64_t  acquireTimeNs = steadyNowNs();
+
+        int slot;
+        if (!captureFree_.pop(slot))
+        {
+            captureDrops_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        PipelineFrame& f = capturePool_[slot];
+        f.width     = frame.width;
+        f.height    = frame.height;
+        f.frameId   = frame.frameId;
+        f.timestamp     = frame.timestamp;
+        f.captureTimeUs = captureTimeUs;
+        f.acquireTimeNs = acquireTimeNs;
+        f.hasPixels     = frame.data != nullptr;
+        if (f.hasPixels)
+        {
+            memcpy(f.pixels.data(), frame.data, f.pixels.size());
+            f.objects.clear();
+        }
+        else
+        {
+            // 객체 모드: 프레임당 수십 바이트만 복사 (영상 전송·분할 없음)
+            f.objects.assign(frame.objects, frame.objects + frame.objectCount);
+        }
+
+        captured_.push(slot);   // 슬롯 수 == 링 용량이므로 실패하지 않음
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+        }
+        wakeCv_.notify_one();
+    }
+}
+
+// ─────────────────────────────────────────────────────────
+//  처리 스레드
+// ─────────────────────────────────────────────────────────
+
+bool TrackingPipeline::waitForFrame()
+{
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    return wakeCv_.wait_for(lock, std::chrono::milliseconds(10),
+                            [this] { return !captured_.empty() || !running_.load(); });
+}
+
+void TrackingPipeline::processLoop()
+{
+    while (running_.load())
+    {
+        // pop 전에 busy 를 세워 drained() 가 "큐는 비었지만 처리 중" 상태를 놓치지 않게 함
+        busy_.store(true);
+        int slot;
+        if (!captured_.pop(slot))
+        {
+            busy_.store(false);
+            waitForFrame();
+            continue;
+        }
+
+        // drain-to-latest: 밀린 프레임은 처리하지 않고 바로 반환
+        int newer;
+        while (captured_.pop(newer))
+        {
+            captureFree_.push(slot);
+            staleDrops_.fetch_add(1, std::memory_order_relaxed);
+            slot = newer;
+        }
+
+        refreshConfig();
+
+        // 컨트롤러 임계값은 처리 스레드 사본에만 반영 (다음 refreshConfig 에서 원래 값으로 복사됨)
+        config_.settings.levels.threshold = levels_.threshold();
+
+        PipelineFrame& f = capturePool_[slot];
+        // 녹화는 배경 억제 전 원본 픽셀 (현장에서 카메라가 본 그대로), 중심점은 검출 뒤 endFrame 에서
+        recorder_.beginFrame(f.hasPixels ? f.pixels.data() : nullptr, f.width, f.height, f.frameId,
+                             f.timestamp, f.captureTimeUs);
+        suppressBackground(f);
+        const FrameResult& r = f.hasPixels
+            ? processor_.detect(f.pixels.data(), f.width, f.height, config_.hom, config_.settings)
+            : processor_.ingestObjects(f.objects.data(), static_cast<int>(f.objects.size()),
+                                       f.width, f.height, config_.hom, config_.settings);
+        FrameTimestamps timing;
+        timing.acquireNs = f.acquireTimeNs;
+        timing.detectNs  = steadyNowNs();
+        lastAllocs_.store(processor_.lastFrameAllocations(), std::memory_order_relaxed);
+        recorder_.endFrame(r.blobs);
+
+        // 히스토그램 → 다음 프레임 임계값 / 노출 (객체 모드 프레임은 픽셀이 없어 건너뜀)
+        int exposure;
+        if (f.hasPixels && levels_.update(f.pixels.data(), f.width, f.height, r.detectionRoi, r.blobs, exposure))
+            pendingExposure_.store(exposure);
+        levelThreshold_.store(levels_.threshold(), std::memory_order_relaxed);
+        levelExposure_.store(levels_.exposure(), std::memory_order_relaxed);
+        levelBackground_.store(levels_.background(), std::memory_order_relaxed);
+        levelPeak_.store(levels_.peak(), std::memory_order_relaxed);
+        processedFrames_.fetch_add(1, std::memory_order_relaxed);
+
+        // 카메라/녹화 타임스탬프가 있으면 그 간격으로 추적 (재생 속도와 무관), 없으면 acquire 시각
+        double frameTime = f.timestamp > 0.0 ? f.timestamp : f.acquireTimeNs * 1e-9;
+        merger_.submit(camera_, config_.hom.ready, r.inBoundCenters, r.inBoundAreas,
+                       f.frameId, f.captureTimeUs, frameTime, timing, config_.settings);
+
+        if (objectWriter_)
+            objectWriter_->write(f.frameId, frameTime, r.blobs);
+
+        if (withDisplay_ && displayEnabled_.load())
+        {
+            if (!source_.objectMode())
+            {
+                if (++displayCounter_ % DISPLAY_EVERY == 0) handToDisplay(f);
+            }
+            else if (f.hasPixels)
+            {
+                handToDisplay(f);       // 요청해서 받은 grayscale 미리보기
+            }
+            else
+            {
+                // grayscale 을 요청할 수 없거나 (재생) 요청하지 않도록 설정했으면 객체로 합성
+                int every = config_.settings.objectPreviewEvery;
+                if (++displayCounter_ % (every > 0 ? every : DISPLAY_EVERY) == 0 &&
+                    (every == 0 || !source_.requestGrayscale()))
+                    handToDisplay(f);
+            }
+        }
+
+        captureFree_.push(slot);
+        busy_.store(false);
+    }
+}
+
+// 학습된 정적 배경을 검출 전에 제거. 픽셀 프레임은 마스크 run 안의 배경 밝기 이하 픽셀을 0 으로,
+// 객체 모드 프레임은 중심이 마스크 안인 객체를 버림. 학습 때와 해상도가 다르면 적용하지 않음.
+void TrackingPipeline::suppressBackground(PipelineFrame& f) const
+{
+    const BackgroundMask& mask = config_.background;
+    if (!config_.settings.backgroundSuppression || mask.empty() || !mask.matches(f.width, f.height))
+        return;
+
+    if (f.hasPixels)
+    {
+        mask.apply(f.pixels.data(), config_.settings.backgroundMargin);
+        return;
+    }
+    f.objects.erase(std::remove_if(f.objects.begin(), f.objects.end(),
+                                   [&mask](const SourceObject& o) { return mask.contains(o.x, o.y); }),
+                    f.objects.end());
+}
+
+void TrackingPipeline::handToDisplay(const PipelineFrame& src)
+{
+    int slot;
+    if (!displayFree_.pop(slot))
+    {
+        displayDrops_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    PipelineFrame& d = displayPool_[slot];
+    d.width     = src.width;
+    d.height    = src.height;
+    d.frameId   = src.frameId;
+    d.timestamp     = src.timestamp;
+    d.captureTimeUs = src.captureTimeUs;
+    d.acquireTimeNs = src.acquireTimeNs;
+    d.hasPixels     = true;
+    if (src.hasPixels)
+    {
+        memcpy(d.pixels.data(), src.pixels.data(), d.pixels.size());
+    }
+    else
+    {
+        // 객체 목록 → 검은 배경 위 면적만 한 밝은 원 (표시 처리기가 다시 검출해 패널을 그림)
+        cv::Mat img(d.height, d.width, CV_8UC1, d.pixels.data());
+        img.setTo(cv::Scalar(0));
+        for (const SourceObject& o : src.objects)
+        {
+            float r = std::max(1.f, std::sqrt(o.area / 3.14159265f));
+            cv::circle(img, cv::Point(cvRound(o.x * 16.f), cvRound(o.y * 16.f)), cvRound(r * 16.f),
+                       cv::Scalar(255), cv::FILLED, cv::LINE_AA, 4);
+        }
+    }
+    displayReady_.push(slot);
+}
+
+// ─────────────────────────────────────────────────────────
+//  표시 스레드
+// ─────────────────────────────────────────────────────────
+
+const PipelineFrame* TrackingPipeline::acquireDisplayFrame()
+{
+    releaseDisplayFrame();
+
+    int slot;
+    if (!displayReady_.pop(slot)) return nullptr;
+
+    // 표시가 밀렸으면 가장 최근 프레임만 보여줌
+    int newer;
+    while (displayReady_.pop(newer))
+    {
+        displayFree_.push(slot);
+        slot = newer;
+    }
+    heldDisplay_ = slot;
+    return &displayPool_[slot];
+}
+
+void TrackingPipeline::releaseDisplayFrame()
+{
+    if (heldDisplay_ < 0) return;
+    displayFree_.push(heldDisplay_);
+    heldDisplay_ = -1;
+}
+
+PipelineStats TrackingPipeline::stats() const
+{
+    PipelineStats s;
+    s.captureQueue     = static_cast<int>(captured_.size());
+    s.displayQueue     = static_cast<int>(displayReady_.size());
+    s.captureDrops     = captureDrops_.load(std::memory_order_relaxed);
+    s.staleDrops       = staleDrops_.load(std::memory_order_relaxed);
+    s.displayDrops     = displayDrops_.load(std::memory_order_relaxed);
+    s.processedFrames  = processedFrames_.load(std::memory_order_relaxed);
+    s.frameAllocations = lastAllocs_.load(std::memory_order_relaxed);
+    s.threshold        = levelThreshold_.load(std::memory_order_relaxed);
+    s.exposure         = levelExposure_.load(std::memory_order_relaxed);
+    s.background       = levelBackground_.load(std::memory_order_relaxed);
+    s.peak             = levelPeak_.load(std::memory_order_relaxed);
+    return s;
+}
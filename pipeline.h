@@ -0,0 +1,184 @@
+#pragma once
+
+#include "background_mask.h"
+#include "frame_recorder.h"
+#include "frame_source.h"
+#include "frame_processor.h"
+#include "homography.h"
+#include "level_controller.h"
+#include "object_list.h"
+#include "point_merger.h"
+#include "settings.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ========== 파이프라인 프레임 슬롯 ==========
+// 픽셀 버퍼는 풀 생성 시 한 번만 할당되고, 스레드 사이에는 슬롯 인덱스만 오간다.
+// 객체 모드 프레임은 픽셀을 복사하지 않고 objects 만 채운다 (hasPixels == false).
+struct PipelineFrame
+{
+    std::vector<uint8_t>      pixels;       // width × height, stride == width
+    std::vector<SourceObject> objects;      // 객체 모드: 카메라가 보고한 객체 (MAX_SOURCE_OBJECTS 예약)
+    bool     hasPixels     = true;
+    int      width         = 0;
+    int      height        = 0;
+    uint32_t frameId       = 0;
+    double   timestamp     = 0.0;
+    uint64_t captureTimeUs = 0;     // 캡처 스레드가 프레임을 받은 시각 (system_clock µs)
+    int64_t  acquireTimeNs = 0;     // 같은 시각 (steady_clock ns, 종단 간 지연 측정용)
+};
+
+// ========== 파이프라인 통계 (OSD / 종료 로그용 스냅샷) ==========
+struct PipelineStats
+{
+    int  captureQueue     = 0;  // 캡처 → 처리 대기 프레임 수
+    int  displayQueue     = 0;  // 처리 → 표시 대기 프레임 수
+    long captureDrops     = 0;  // 빈 슬롯이 없어 캡처 단계에서 버린 프레임
+    long staleDrops       = 0;  // 처리 스레드가 최신 프레임만 남기며 건너뛴 프레임
+    long displayDrops     = 0;  // 표시 스레드가 밀려 표시 슬롯을 못 받은 프레임
+    long processedFrames  = 0;
+    int  frameAllocations = 0;  // 처리 스레드 FrameProcessor 직전 프레임 할당 수
+    int  threshold        = 0;  // 현재 이진화 임계값 (auto_threshold 면 컨트롤러 값)
+    int  exposure         = 0;  // 현재 노출 (auto_exposure 면 컨트롤러 값)
+    int  background       = 0;  // 최근 배경 밝기 분위수 / 점 밝기 (자동 조절 켰을 때만)
+    int  peak             = 0;
+};
+
+// ========== 캡처 / 처리 / 표시 파이프라인 ==========
+//
+//   [캡처 스레드] --captured_--> [처리 스레드] --displayReady_--> [표시 = 호출 스레드]
+//        ^                            |  ^                              |
+//        +-------captureFree_---------+  +--------displayFree_----------+
+//
+// 모든 링은 단일 생산자/단일 소비자. 어느 단계도 다음 단계를 기다리며 블로킹하지 않는다:
+//   - 캡처: 빈 슬롯이 없으면 프레임을 버림 (captureDrops)
+//   - 처리: 대기 중인 프레임이 여러 개면 가장 최신 것만 처리 (staleDrops)
+//   - 표시: 4프레임마다 1장을 복사해 넘기되, 빈 표시 슬롯이 없으면 건너뜀 (displayDrops)
+//     객체 모드 소스는 object_preview_every 프레임마다 grayscale 1장을 요청해 그 프레임을 표시하고,
+//     grayscale 을 줄 수 없는 소스(객체 목록 재생)는 객체 목록으로 미리보기 영상을 합성한다.
+// 따라서 imshow 지연이나 모달 설정 다이얼로그가 검출/전송 지연에 영향을 주지 않는다.
+//
+// 호모그래피/설정은 GUI 스레드가 publishConfig() 로 복사본을 게시하고,
+// 처리 스레드는 버전이 바뀐 프레임에서만 잠깐 mutex 를 잡아 가져간다.
+//
+// 카메라마다 파이프라인 하나 (자기 코너/호모그래피). 검출 결과는 PointMerger 로 넘어가
+// 다른 카메라 결과와 병합 → 추적 → UDPSender 로 전달된다.
+class TrackingPipeline
+{
+public:
+    static constexpr int CAPTURE_SLOTS = 4;
+    static constexpr int DISPLAY_SLOTS = 2;
+    static constexpr int DISPLAY_EVERY = 4;     // 처리 프레임 N개당 표시 1회 (~30fps @120fps)
+
+    TrackingPipeline(IFrameSource& source, PointMerger& merger, int camera);
+    ~TrackingPipeline();
+
+    // withDisplay == false 이면 표시 슬롯으로 복사하지 않음 (헤드리스).
+    // start() 전에 publishConfig() 를 한 번 호출해 둘 것.
+    void start(bool withDisplay);
+
+    // 표시 중인 카메라만 표시 프레임을 복사 (다중 카메라에서 화면에 안 보이는 카메라는 생략)
+    void setDisplayEnabled(bool on) { displayEnabled_.store(on); }
+    void stop();
+
+    // GUI 스레드 → 처리 스레드 설정 게시 (background: 이 카메라의 학습 배경 마스크, 비어 있으면 억제 안 함)
+    void publishConfig(const HomographyState& hom, const AppSettings& settings,
+                       const BackgroundMask& background);
+
+    // 노출 변경은 캡처 스레드가 다음 프레임 전에 적용
+    void requestExposure(int exposure) { pendingExposure_.store(exposure); }
+
+    // start() 전에 호출: 처리한 프레임마다 검출 객체(중심점 + 면적)를 .irobj 로 기록
+    void recordObjects(std::unique_ptr<ObjectListWriter> writer) { objectWriter_ = std::move(writer); }
+
+    // 원시 프레임 녹화 (.irrec): start()/stop()/통계는 GUI 스레드, 프레임 기록은 처리 스레드.
+    // 처리 스레드는 버퍼가 모자라면 프레임을 버릴 뿐 기다리지 않는다.
+    FrameRecorder& recorder() { return recorder_; }
+
+    // 표시 스레드 전용: 가장 최근 표시 프레임 (없으면 nullptr). 사용 후 releaseDisplayFrame().
+    const PipelineFrame* acquireDisplayFrame();
+    void                 releaseDisplayFrame();
+
+    // 재생 소스가 끝났고 처리 대기 프레임도 없으면 true
+    bool drained() const { return sourceFinished_.load() && captured_.empty() && !busy_.load(); }
+
+    PipelineStats stats() const;
+
+    // stop() 이후에만 호출 (처리 스레드 FrameProcessor 누적 할당 수)
+    long totalAllocations() const { return processor_.totalAllocations(); }
+
+private:
+    struct ConfigSnapshot
+    {
+        HomographyState hom;
+        AppSettings     settings;
+        BackgroundMask  background;
+    };
+
+    static void copyConfig(ConfigSnapshot& dst, const HomographyState& hom,
+                           const AppSettings& settings, const BackgroundMask& background);
+
+    void suppressBackground(PipelineFrame& f) const;
+
+    void captureLoop();
+    void processLoop();
+    bool waitForFrame();
+    void refreshConfig();
+    void handToDisplay(const PipelineFrame& src);
+
+    IFrameSource& source_;
+    PointMerger&  merger_;
+    int           camera_;
+
+    // 프레임 풀 + 슬롯 인덱스 링
+    std::vector<PipelineFrame>        capturePool_;
+    std::vector<PipelineFrame>        displayPool_;
+    SpscRing<int, CAPTURE_SLOTS>      captureFree_;     // 처리 → 캡처
+    SpscRing<int, CAPTURE_SLOTS>      captured_;        // 캡처 → 처리
+    SpscRing<int, DISPLAY_SLOTS>      displayFree_;     // 표시 → 처리
+    SpscRing<int, DISPLAY_SLOTS>      displayReady_;    // 처리 → 표시
+    int                               heldDisplay_ = -1;
+
+    // 처리 스레드 깨우기 (링 자체는 lock-free, 대기만 condvar)
+    std::mutex              wakeMutex_;
+    std::condition_variable wakeCv_;
+
+    // 설정 게시
+    mutable std::mutex    configMutex_;
+    ConfigSnapshot        published_;
+    std::atomic<uint64_t> configVersion_{0};
+    uint64_t              appliedVersion_ = 0;
+    ConfigSnapshot        config_;                  // 처리 스레드 전용
+
+    FrameProcessor  processor_;                     // 처리 스레드 전용
+    LevelController levels_;                        // 처리 스레드 전용 (auto_threshold / auto_exposure)
+    std::unique_ptr<ObjectListWriter> objectWriter_;  // 처리 스레드 전용 (--record-objects)
+    FrameRecorder   recorder_;
+
+    std::thread       captureThread_;
+    std::thread       processThread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> busy_{false};
+    std::atomic<bool> displayEnabled_{true};
+    std::atomic<bool> sourceFinished_{false};
+    std::atomic<int>  pendingExposure_{-1};
+    bool              withDisplay_ = true;
+    int               displayCounter_ = 0;
+
+    std::atomic<long> captureDrops_{0};
+    std::atomic<long> staleDrops_{0};
+    std::atomic<long> displayDrops_{0};
+    std::atomic<long> processedFrames_{0};
+    std::atomic<int>  lastAllocs_{0};
+    std::atomic<int>  levelThreshold_{0};
+    std::atomic<int>  levelExposure_{0};
+    std::atomic<int>  levelBackground_{0};
+    std::atomic<int>  levelPeak_{0};
+};
@@ -0,0 +1,163 @@
+#include "point_merger.h"
+
+#include <algorithm>
+
+// 카메라당 / 병합 결과 최대 점 수 (steady-state 재할당 방지용 예약)
+static constexpr size_t RESERVED_POINTS = 128;
+
+static TrackerParams trackerParams(const AppSettings& s)
+{
+    TrackerParams p;
+    p.gatePx      = s.trackGatePx;
+    p.maxMissed   = s.trackMaxMissed;
+    p.accelNoise  = s.trackAccelNoise;
+    p.measNoisePx = s.trackMeasNoise;
+    p.predictMs   = s.trackPredictMs;
+    return p;
+}
+
+PointMerger::PointMerger(UDPSender& sender, int cameraCount)
+    : sender_(sender), cameras_(std::max(1, std::min(MAX_CAMERAS, cameraCount)))
+{
+    for (CameraSlot& slot : cameras_)
+    {
+        slot.points.reserve(RESERVED_POINTS);
+        slot.areas.reserve(RESERVED_POINTS);
+        slot.counted.reserve(RESERVED_POINTS);
+    }
+    size_t total = RESERVED_POINTS * cameras_.size();
+    merged_.reserve(total);
+    mergedAreas_.reserve(total);
+    mergedCount_.reserve(total);
+    mergedCameras_.reserve(total);
+    held_.reserve(total);
+}
+
+// 카메라 순서대로 점을 쌓되, 이미 쌓인 다른 카메라의 점과 mergeRadiusPx 이내면 가장 가까운 것에 합침.
+// 같은 카메라의 점끼리는 서로 다른 블롭이므로 합치지 않는다. 다른 카메라가 submit 할 때마다 같은 프레임이
+// 다시 병합되므로, 중복 수는 카메라 프레임의 점마다 처음 합쳐질 때 한 번만 센다.
+void PointMerger::mergeCameras(int camera, int64_t nowAcquireNs, const AppSettings& settings)
+{
+    merged_.clear();
+    mergedAreas_.clear();
+    mergedCount_.clear();
+    mergedCameras_.clear();
+
+    int64_t maxAgeNs = static_cast<int64_t>(settings.mergeMaxAgeMs) * 1000000LL;
+    float   radius2  = settings.mergeRadiusPx * settings.mergeRadiusPx;
+    for (size_t c = 0; c < cameras_.size(); c++)
+    {
+        CameraSlot& slot = cameras_[c];
+        if (!slot.ready) continue;
+        if (static_cast<int>(c) != camera && nowAcquireNs - slot.acquireNs > maxAgeNs) continue;
+
+        uint32_t bit = 1u << c;
+        for (size_t i = 0; i < slot.points.size(); i++)
+        {
+            const cv::Point2f& p = slot.points[i];
+            int   match = -1;
+            float best  = radius2;
+            for (size_t m = 0; m < merged_.size(); m++)
+            {
+                if (mergedCameras_[m] & bit) continue;
+                cv::Point2f d  = merged_[m] - p;
+                float       d2 = d.x * d.x + d.y * d.y;
+                if (d2 <= best)
+                {
+                    best  = d2;
+                    match = static_cast<int>(m);
+                }
+            }
+
+            if (match >= 0)
+            {
+                float n = static_cast<float>(mergedCount_[match]);
+                merged_[match]         = (merged_[match] * n + p) / (n + 1.f);
+                mergedAreas_[match]    = std::max(mergedAreas_[match], slot.areas[i]);
+                mergedCount_[match]   += 1;
+                mergedCameras_[match] |= bit;
+                if (!slot.counted[i])
+                {
+                    slot.counted[i] = 1;
+                    duplicates_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            else
+            {
+                merged_.push_back(p);
+                mergedAreas_.push_back(slot.areas[i]);
+                mergedCount_.push_back(1);
+                mergedCameras_.push_back(bit);
+            }
+        }
+    }
+}
+
+void PointMerger::submit(int camera, bool homReady,
+                         const std::vector<cv::Point2f>& points,
+                         const std::vector<int>&         areas,
+                         uint32_t                        frameId,
+                         uint64_t                        captureTimeUs,
+                         double                          frameTime,
+                         const FrameTimestamps&          timing,
+                         const AppSettings&              settings)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (resetRequested_.exchange(false))
+    {
+        tracker_.reset();
+        lastTrackTime_ = 0.0;
+    }
+
+    CameraSlot& slot = cameras_[camera];
+    slot.ready     = homReady;
+    slot.acquireNs = timing.acquireNs;
+    slot.points.assign(points.begin(), points.end());
+    slot.areas.assign(areas.begin(), areas.end());
+    slot.counted.assign(points.size(), 0);
+
+    bool anyReady = false;
+    for (const CameraSlot& s : cameras_) anyReady = anyReady || s.ready;
+    if (!anyReady) return;
+
+    mergeCameras(camera, timing.acquireNs, settings);
+
+    // 추적은 전송 여부와 무관하게 매 프레임 돌려 [U] 토글 후에도 ID 가 이어지게 함.
+    // 카메라가 여럿이면 카메라 시계가 서로 다르므로 acquire 시각을 쓰고, 스레드 도착 순서가
+    // 뒤바뀌어도 시간이 역행하지 않게 단조 증가로 맞춘다.
+    // 측정은 이 카메라의 이번 점뿐. 다른 카메라의 점은 그 카메라 submit 때 이미 측정으로 반영됐으므로
+    // held 로만 넘겨 (보정 없이) 그 시야에만 있는 트랙이 미검출로 사라지지 않게 한다.
+    const TrackedPoints* tracked = nullptr;
+    if (settings.tracking)
+    {
+        int64_t maxAgeNs = static_cast<int64_t>(settings.mergeMaxAgeMs) * 1000000LL;
+        held_.clear();
+        for (size_t c = 0; c < cameras_.size(); c++)
+        {
+            const CameraSlot& other = cameras_[c];
+            if (static_cast<int>(c) == camera || !other.ready) continue;
+            if (timing.acquireNs - other.acquireNs > maxAgeNs) continue;
+            held_.insert(held_.end(), other.points.begin(), other.points.end());
+        }
+        if (!slot.ready)
+        {
+            slot.points.clear();
+            slot.areas.clear();
+        }
+
+        double t = frameTime;
+        if (cameras_.size() > 1)
+            t = std::max(timing.acquireNs * 1e-9, lastTrackTime_ + 1e-6);
+        lastTrackTime_ = t;
+        tracked = &tracker_.update(slot.points, slot.areas, t, trackerParams(settings), &held_);
+    }
+
+    if (!sending_.load()) return;
+
+    // 카메라가 여럿이면 카메라별 프레임 번호가 섞이므로 병합 결과 순번을 보냄
+    uint32_t id = cameras_.size() > 1 ? ++mergedFrameId_ : frameId;
+    if (tracked)
+        sender_.updatePoints(*tracked, id, captureTimeUs, &timing);
+    else
+        sender_.updatePoints(merged_, &mergedAreas_, id, captureTimeUs, &timing);
+}
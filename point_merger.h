@@ -0,0 +1,75 @@
+#pragma once
+
+#include "settings.h"
+#include "target_tracker.h"
+#include "udp_sender.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// ========== 다중 카메라 결과 병합 → 추적 → UDP 전송 ==========
+// 카메라마다 처리 스레드(TrackingPipeline)가 submit() 으로 타깃 평면 좌표를 넘긴다. 호출마다
+//   1) 해당 카메라의 최신 결과를 갱신
+//   2) mergeMaxAgeMs 이내인 모든 카메라 결과를 합치되, 서로 다른 카메라의 점이 mergeRadiusPx
+//      이내면 하나로 합침 (겹치는 시야의 중복 제거, 위치는 평균)
+//   3) tracking=1 이면 추적 → 전송 스레드에 전달. 추적기에는 제출한 카메라의 이번 점만 측정으로 넣고
+//      (그 카메라의 acquire 시각), 다른 카메라의 최근 점은 그 시야에만 있는 트랙을 유지하는 데만 쓴다 —
+//      이미 반영된 관측을 매 submit 마다 새 측정으로 다시 넣지 않기 위해서.
+// 병합은 점 수십 개 규모라 mutex 구간이 짧고, 비용 대부분인 검출은 카메라별 스레드에서 병렬로 돈다.
+// 카메라 1대면 합칠 상대가 없으므로 기존 단일 카메라 경로와 같은 결과.
+class PointMerger
+{
+public:
+    PointMerger(UDPSender& sender, int cameraCount);
+
+    // 병합 결과를 UDPSender 로 넘길지 여부 ([U] 키)
+    void setSending(bool on) { sending_.store(on); }
+
+    // 코너/타깃 해상도가 바뀌면 호출 (어느 스레드에서나): 다음 submit 에서 기존 트랙 폐기
+    void resetTracks() { resetRequested_.store(true); }
+
+    // 카메라 처리 스레드에서 호출. points / areas 는 그 카메라의 inBoundCenters / inBoundAreas.
+    // frameTime 은 카메라 타임스탬프 (초) — 카메라 1대일 때만 추적 시간축으로 사용.
+    void submit(int camera, bool homReady,
+                const std::vector<cv::Point2f>& points,
+                const std::vector<int>&         areas,
+                uint32_t                        frameId,
+                uint64_t                        captureTimeUs,
+                double                          frameTime,
+                const FrameTimestamps&          timing,
+                const AppSettings&              settings);
+
+    // 누적 중복 제거 수 (다른 카메라와 겹쳐 합쳐진 점, 카메라 프레임의 점마다 한 번만 셈)
+    long duplicatesMerged() const { return duplicates_.load(std::memory_order_relaxed); }
+
+private:
+    struct CameraSlot
+    {
+        bool                     ready     = false;
+        int64_t                  acquireNs = 0;
+        std::vector<cv::Point2f> points;
+        std::vector<int>         areas;
+        std::vector<char>        counted;       // 점별: 이미 duplicates_ 에 셌음 (새 프레임이 오면 초기화)
+    };
+
+    void mergeCameras(int camera, int64_t nowAcquireNs, const AppSettings& settings);
+
+    UDPSender& sender_;
+
+    std::mutex               mutex_;            // submit() 직렬화 (UDPSender 단일 생산자 조건 포함)
+    std::vector<CameraSlot>  cameras_;
+    std::vector<cv::Point2f> merged_;
+    std::vector<int>         mergedAreas_;
+    std::vector<int>         mergedCount_;      // 평균에 들어간 점 수
+    std::vector<uint32_t>    mergedCameras_;    // 합쳐진 카메라 비트마스크
+    std::vector<cv::Point2f> held_;             // 추적기에 넘기는 다른 카메라의 최근 점
+    TargetTracker            tracker_;
+    double                   lastTrackTime_ = 0.0;
+    uint32_t                 mergedFrameId_ = 0;
+
+    std::atomic<bool> sending_{false};
+    std::atomic<bool> resetRequested_{false};
+    std::atomic<long> duplicates_{0};
+};
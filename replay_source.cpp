@@ -0,0 +1,177 @@
+#include "replay_source.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ─────────────────────────────────────────────────────────
+//  읽기 전용 메모리 매핑 (플랫폼별)
+// ─────────────────────────────────────────────────────────
+
+struct ReplayFrameSource::MappedFile
+{
+    const unsigned char* data = nullptr;
+    size_t               size = 0;
+#ifdef _WIN32
+    HANDLE hFile    = INVALID_HANDLE_VALUE;
+    HANDLE hMapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    bool open(const std::string& path)
+    {
+#ifdef _WIN32
+        hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER li;
+        if (!GetFileSizeEx(hFile, &li) || li.QuadPart == 0) return false;
+        size = static_cast<size_t>(li.QuadPart);
+
+        hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!hMapping) return false;
+
+        data = static_cast<const unsigned char*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+        return data != nullptr;
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) return false;
+        size = static_cast<size_t>(st.st_size);
+
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) return false;
+        madvise(p, size, MADV_SEQUENTIAL);
+        data = static_cast<const unsigned char*>(p);
+        return true;
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (data)                         UnmapViewOfFile(data);
+        if (hMapping)                     CloseHandle(hMapping);
+        if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+#else
+        if (data) munmap(const_cast<unsigned char*>(data), size);
+        if (fd >= 0) ::close(fd);
+#endif
+    }
+};
+
+// ─────────────────────────────────────────────────────────
+
+std::unique_ptr<ReplayFrameSource> ReplayFrameSource::open(const std::string& path,
+                                                           ReplayPacing pacing,
+                                                           bool loop,
+                                                           std::string& errorOut)
+{
+    std::unique_ptr<MappedFile> file(new MappedFile());
+    if (!file->open(path))
+    {
+        errorOut = "Cannot open replay file: " + path;
+        return nullptr;
+    }
+    if (file->size < sizeof(ReplayFileHeader))
+    {
+        errorOut = "Replay file too small: " + path;
+        return nullptr;
+    }
+
+    ReplayFileHeader hdr;
+    memcpy(&hdr, file->data, sizeof(hdr));
+    if (memcmp(hdr.magic, "IRRW", 4) != 0 || hdr.version != 1 ||
+        hdr.width == 0 || hdr.height == 0)
+    {
+        errorOut = "Invalid replay file header: " + path;
+        return nullptr;
+    }
+
+    size_t recordSize = sizeof(ReplayFrameHeader) +
+                        static_cast<size_t>(hdr.width) * hdr.height;
+    size_t available  = (file->size - sizeof(ReplayFileHeader)) / recordSize;
+    size_t count      = hdr.frameCount ? std::min<size_t>(hdr.frameCount, available) : available;
+    if (count == 0)
+    {
+        errorOut = "Replay file contains no frames: " + path;
+        return nullptr;
+    }
+
+    std::unique_ptr<ReplayFrameSource> src(new ReplayFrameSource());
+    src->frames_     = file->data + sizeof(ReplayFileHeader);
+    src->file_       = std::move(file);
+    src->recordSize_ = recordSize;
+    src->frameCount_ = static_cast<uint32_t>(count);
+    src->width_      = static_cast<int>(hdr.width);
+    src->height_     = static_cast<int>(hdr.height);
+    src->pacing_     = pacing;
+    src->loop_       = loop;
+
+    std::cout << "[Replay] " << path << ": " << src->frameCount_ << " frames, "
+              << src->width_ << "x" << src->height_
+              << (pacing == ReplayPacing::Realtime ? " (realtime)" : " (as fast as possible)")
+              << (loop ? " (loop)" : "") << std::endl;
+    return src;
+}
+
+ReplayFrameSource::~ReplayFrameSource() = default;
+
+bool ReplayFrameSource::nextFrame(SourceFrame& out)
+{
+    if (finished_) return false;
+
+    if (next_ >= frameCount_)
+    {
+        if (!loop_)
+        {
+            finished_ = true;
+            std::cout << "[Replay] End of file reached." << std::endl;
+            return false;
+        }
+        next_ = 0;
+    }
+
+    const unsigned char* rec = frames_ + recordSize_ * next_;
+    ReplayFrameHeader fh;
+    memcpy(&fh, rec, sizeof(fh));
+
+    if (pacing_ == ReplayPacing::Realtime)
+    {
+        // 첫 프레임(또는 루프 재시작)에서 기준점 설정 후, 녹화 간격대로 대기
+        if (next_ == 0)
+        {
+            wallStart_ = std::chrono::steady_clock::now();
+            firstTsUs_ = fh.timestampUs;
+        }
+        uint64_t offsetUs = fh.timestampUs >= firstTsUs_ ? fh.timestampUs - firstTsUs_ : 0;
+        std::this_thread::sleep_until(wallStart_ + std::chrono::microseconds(offsetUs));
+    }
+
+    out.data      = rec + sizeof(ReplayFrameHeader);
+    out.width     = width_;
+    out.height    = height_;
+    out.frameId   = fh.frameId;
+    out.timestamp = static_cast<double>(fh.timestampUs) * 1e-6;
+    ++next_;
+    return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "frame_source.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// ========== 녹화 파일 포맷 (.irraw) ==========
+// [ReplayFileHeader] + frameCount × ( [ReplayFrameHeader] + width*height 바이트 8-bit grayscale )
+// 모든 정수는 little-endian.
+#pragma pack(push, 1)
+struct ReplayFileHeader
+{
+    char     magic[4];      // "IRRW"
+    uint32_t version;       // 1
+    uint32_t width;
+    uint32_t height;
+    uint32_t frameCount;    // 0 이면 파일 크기로부터 계산
+    uint32_t reserved[3];
+};
+
+struct ReplayFrameHeader
+{
+    uint64_t timestampUs;   // 원본 캡처 타임스탬프 (µs)
+    uint32_t frameId;
+    uint32_t reserved;
+};
+#pragma pack(pop)
+
+// ========== 재생 페이싱 ==========
+enum class ReplayPacing
+{
+    Realtime,       // 녹화된 타임스탬프 간격대로 재생
+    AsFastAsPossible
+};
+
+// ========== 녹화 파일 재생 프레임 소스 (메모리 매핑) ==========
+class ReplayFrameSource : public IFrameSource
+{
+public:
+    // 파일을 메모리 매핑하고 헤더를 검증. 실패 시 nullptr + errorOut.
+    static std::unique_ptr<ReplayFrameSource> open(const std::string& path,
+                                                   ReplayPacing pacing,
+                                                   bool loop,
+                                                   std::string& errorOut);
+    ~ReplayFrameSource() override;
+
+    int  width()  const override { return width_; }
+    int  height() const override { return height_; }
+    bool nextFrame(SourceFrame& out) override;
+    bool finished() const override { return finished_; }
+
+    uint32_t frameCount() const { return frameCount_; }
+
+private:
+    ReplayFrameSource() = default;
+
+    struct MappedFile;
+    std::unique_ptr<MappedFile> file_;
+
+    const unsigned char* frames_     = nullptr;  // 첫 프레임 레코드 시작 위치
+    size_t               recordSize_ = 0;        // ReplayFrameHeader + 픽셀
+    uint32_t             frameCount_ = 0;
+    int                  width_      = 0;
+    int                  height_     = 0;
+
+    ReplayPacing pacing_   = ReplayPacing::Realtime;
+    bool         loop_     = false;
+    bool         finished_ = false;
+    uint32_t     next_     = 0;
+
+    // Realtime 페이싱 기준점: (재생 시작 벽시계, 첫 프레임 타임스탬프)
+    std::chrono::steady_clock::time_point wallStart_;
+    uint64_t                              firstTsUs_ = 0;
+};
@@ -1,4 +1,15 @@
 #include "settings.h"
+
+// Win32 다이얼로그 구현 — Windows 빌드에서만 컴파일됨 (CMakeLists.txt)
+// WIN32_LEAN_AND_MEAN: winsock 충돌 방지
+// NOMINMAX: windows.h의 min/max 매크로가 std::min/std::max를 오염시키는 것 방지
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
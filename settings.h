@@ -1,14 +1,14 @@
 #pragma once
 
-// WIN32_LEAN_AND_MEAN: winsock 충돌 방지
-// NOMINMAX: windows.h의 min/max 매크로가 std::min/std::max를 오염시키는 것 방지
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-#ifndef NOMINMAX
-#define NOMINMAX
-#endif
-#include <windows.h>
+#include <cstdio>
+
+#include "blob_kernel.h"
+#include "frame_source.h"
+#include "blob_labeler.h"
+#include "fiducial_calibration.h"
+#include "lens_model.h"
+#include "level_controller.h"
+#include "packet_format.h"
 
 // ========== 앱 설정 구조체 ==========
 struct AppSettings
@@ -19,17 +19,91 @@ struct AppSettings
     int  targetHeight;
     int  exposure;
     int  udpFps;
+    BlobKernel blobKernel;  // Dilate+Threshold 구현 선택 (setting.cfg: blob_kernel)
+    bool roiDetection;      // 호모그래피 설정 후 4점 바운딩 박스 안에서만 검출
+    bool roiPolygonMask;    // ROI 안에서도 4점 다각형 밖 픽셀은 제외
+    CentroidMode centroidMode;  // 중심점 계산 방식 (setting.cfg: centroid_mode)
+    int  centroidWeightFloor;   // 밝기 가중치 = g - floor (0~254)
+    int  gaussianMaxArea;       // Gaussian 모드에서 피팅할 최대 블롭 면적 (px)
+    int  udpDecimals;           // 텍스트 패킷 좌표 소수 자릿수 (0 = 기존 정수 포맷)
+    PacketFormat udpFormat;     // UDP 패킷 포맷 (setting.cfg: udp_format=text|binary)
+    bool udpSendArea;           // 바이너리 패킷에 블롭 면적 포함
+    UdpSendMode udpSendMode;    // fixed = udpFps 주기 재전송, event = 새 검출마다 즉시 전송
+    int  udpMinIntervalUs;      // event 모드 최소 전송 간격 (µs, 0 = 제한 없음)
+    int  udpKeepaliveMs;        // event 모드에서 새 좌표가 없을 때 재전송 주기 (ms, 0 = 끔)
+    char udpTargets[256];       // 추가 전송 대상 "ip:port,ip:port" (멀티캐스트 허용, 빈 문자열 = 없음)
+    int  udpMulticastTtl;       // 멀티캐스트 TTL
+    bool  tracking;             // 다중 타깃 추적: 고정 ID + 칼만 평활화 (setting.cfg: tracking)
+    float trackGatePx;          // 트랙-검출 대응 최대 거리 (타깃 좌표 px)
+    int   trackMaxMissed;       // 연속 미검출 허용 프레임 수 (넘으면 트랙 삭제, ID 폐기)
+    float trackAccelNoise;      // 칼만 가속도 잡음 (px/s²)
+    float trackMeasNoise;       // 칼만 측정 잡음 (px)
+    float trackPredictMs;       // 출력 위치를 속도로 앞당길 시간 (ms, 지연 보상)
+    int   udpExtrapolateMs;     // 전송 시점 외삽 최대 시간 (ms, 0 = 끔, tracking=1 필요)
+    LensModel lens;             // 렌즈 왜곡 보정 (setting.cfg: lens_*, LensCalibration 으로 생성)
+    FiducialParams fiducial;    // 자동 호모그래피용 기준점 격자 (setting.cfg: fiducial_*)
+    int   cameraCount;          // 동시에 열 카메라 수 (1~MAX_CAMERAS, 카메라마다 코너 4점)
+    float mergeRadiusPx;        // 서로 다른 카메라의 점을 같은 점으로 합칠 거리 (타깃 px)
+    int   mergeMaxAgeMs;        // 다른 카메라의 마지막 결과를 병합에 쓰는 최대 나이 (ms)
+    bool  objectMode;           // 카메라 측 객체 모드: 카메라가 분할한 객체 목록만 받음 (grayscale 전송·호스트 분할 생략)
+    int   objectThreshold;      // 객체 모드 카메라 밝기 임계값 (1~255, 호스트 검출의 200 과 같은 의미)
+    int   objectPreviewEvery;   // 객체 모드에서 처리 프레임 N개당 표시용 grayscale 1장 요청 (0 = 요청 안 함, 객체로 합성)
+    LevelParams levels;         // 이진화 임계값 / 자동 노출 (setting.cfg: threshold, auto_threshold, auto_exposure ...)
+    bool  backgroundSuppression; // 학습된 배경 마스크 적용 ([B] 키로 학습, 마스크 자체는 background= 키)
+    int   backgroundMargin;     // 마스크 run 안에서 학습 밝기 + margin 보다 밝은 픽셀만 통과
+    int   backgroundGrowPx;     // 학습된 정적 픽셀 주변으로 넓힐 px
+    int   backgroundLearnMs;    // [B] 학습 시간 (ms)
+    float backgroundPresence;   // 학습 프레임 중 이 비율 이상 밝았던 픽셀만 배경 (지나가는 타깃 제외)
+    int   recordChunkFrames;    // [V] 원시 프레임 녹화: 청크당 프레임 수
+    int   recordBuffers;        // 미리 할당하는 청크 버퍼 수
+    bool  recordLz4;            // 청크 LZ4 압축 (LZ4 지원 빌드에서만)
 
     AppSettings()
     {
-        strcpy_s(ipAddress, sizeof(ipAddress), "127.0.0.1");
+        snprintf(ipAddress, sizeof(ipAddress), "%s", "127.0.0.1");
         port         = 7777;
         targetWidth  = 1024;
         targetHeight = 768;
         exposure     = 7500;
         udpFps       = 60;
+        blobKernel   = BlobKernel::Auto;
+        roiDetection   = true;
+        roiPolygonMask = false;
+        centroidMode        = CentroidMode::Weighted;
+        centroidWeightFloor = 32;
+        gaussianMaxArea     = 400;
+        udpDecimals         = 0;
+        udpFormat           = PacketFormat::Text;
+        udpSendArea         = false;
+        udpSendMode         = UdpSendMode::Fixed;
+        udpMinIntervalUs    = 0;
+        udpKeepaliveMs      = 100;
+        udpTargets[0]       = '\0';
+        udpMulticastTtl     = 1;
+        tracking            = false;
+        trackGatePx         = 40.f;
+        trackMaxMissed      = 5;
+        trackAccelNoise     = 3000.f;
+        trackMeasNoise      = 0.5f;
+        trackPredictMs      = 0.f;
+        udpExtrapolateMs    = 0;
+        cameraCount         = 1;
+        mergeRadiusPx       = 8.f;
+        mergeMaxAgeMs       = 50;
+        objectMode          = false;
+        objectThreshold     = 200;
+        objectPreviewEvery  = 8;
+        backgroundSuppression = true;
+        backgroundMargin    = 20;
+        backgroundGrowPx    = 1;
+        backgroundLearnMs   = 3000;
+        backgroundPresence  = 0.5f;
+        recordChunkFrames   = 8;
+        recordBuffers       = 8;
+        recordLz4           = true;
     }
 };
 
+// Win32 설정 다이얼로그 (settings.cpp, Windows 전용 모듈)
 // true = OK 눌림 / false = Cancel 또는 창 닫기
 bool ShowSettingsDialog(AppSettings& settings);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// ========== 단일 생산자 / 단일 소비자 링 버퍼 (lock-free) ==========
+// push() 는 생산자 스레드 하나에서만, pop() 은 소비자 스레드 하나에서만 호출해야 한다.
+// 가득 차면 push() 가 false 를 반환할 뿐 블로킹하지 않는다 (드롭 정책은 호출자가 결정).
+// 파이프라인에서는 프레임 슬롯 인덱스(int)만 주고받고, 픽셀 버퍼는 풀에 고정되어 재사용된다.
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+public:
+    bool push(const T& value)
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        if (head - tail == Capacity) return false;
+        buffer_[head & (Capacity - 1)] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out)
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        if (tail == head) return false;
+        out = buffer_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 어느 스레드에서든 호출 가능한 근사치 (OSD 표시용). 소유 스레드가 아니면 두 인덱스를 한 시점에
+    // 읽을 수 없으므로 tail 을 먼저 읽고 (tail ≤ 이후의 head) 결과를 [0, Capacity] 로 제한한다.
+    size_t size() const
+    {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t head = head_.load(std::memory_order_acquire);
+        if (head < tail) return 0;
+        size_t n = head - tail;
+        return n > Capacity ? Capacity : n;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    // 생산자/소비자 인덱스를 서로 다른 캐시 라인에 두어 false sharing 방지
+    alignas(64) std::atomic<size_t> head_{0};   // 생산자만 쓰기
+    alignas(64) std::atomic<size_t> tail_{0};   // 소비자만 쓰기
+    alignas(64) T buffer_[Capacity];
+};
@@ -0,0 +1,205 @@
+#include "target_tracker.h"
+#include <algorithm>
+
+// 새 트랙의 초기 속도 불확실성 (px/s) — 첫 보정에서 속도가 빠르게 수렴하도록 크게
+static constexpr float INIT_VELOCITY_SIGMA = 1000.f;
+
+// 이보다 긴 프레임 간격이면 예측이 의미 없으므로 초기화 (일시정지, 녹화 반복 재생 등)
+static constexpr double MAX_FRAME_GAP_SEC = 0.5;
+
+// 출력/내부 버퍼 초기 capacity (UDP 배치 최대 점 수의 2배 — 잡음 블롭 포함)
+static constexpr size_t RESERVE_TRACKS = 128;
+
+// ─────────────────────────────────────────────────────────
+//  축별 상수 속도 칼만 필터
+// ─────────────────────────────────────────────────────────
+
+void TargetTracker::Axis::init(float z, float measVar)
+{
+    p   = z;
+    v   = 0.f;
+    P00 = measVar;
+    P01 = 0.f;
+    P11 = INIT_VELOCITY_SIGMA * INIT_VELOCITY_SIGMA;
+}
+
+// F = [1 dt; 0 1], Q = accelVar · [dt⁴/4 dt³/2; dt³/2 dt²]  (백색 가속도 잡음)
+void TargetTracker::Axis::predict(float dt, float accelVar)
+{
+    float dt2 = dt * dt;
+    p   += v * dt;
+    P00 += dt * (2.f * P01 + dt * P11) + accelVar * dt2 * dt2 * 0.25f;
+    P01 += dt * P11 + accelVar * dt2 * dt * 0.5f;
+    P11 += accelVar * dt2;
+}
+
+// H = [1 0]
+void TargetTracker::Axis::correct(float z, float measVar)
+{
+    float s  = P00 + measVar;
+    float k0 = P00 / s;
+    float k1 = P01 / s;
+    float y  = z - p;
+    p   += k0 * y;
+    v   += k1 * y;
+    P11 -= k1 * P01;
+    P00 *= (1.f - k0);
+    P01 *= (1.f - k0);
+}
+
+// ─────────────────────────────────────────────────────────
+//  TargetTracker
+// ─────────────────────────────────────────────────────────
+
+TargetTracker::TargetTracker()
+{
+    tracks_.reserve(RESERVE_TRACKS);
+    candidates_.reserve(RESERVE_TRACKS * 4);
+    detTrack_.reserve(RESERVE_TRACKS);
+    heldUsed_.reserve(RESERVE_TRACKS);
+    trackMatched_.reserve(RESERVE_TRACKS);
+    out_.points.reserve(RESERVE_TRACKS);
+    out_.velocities.reserve(RESERVE_TRACKS);
+    out_.areas.reserve(RESERVE_TRACKS);
+    out_.ids.reserve(RESERVE_TRACKS);
+}
+
+void TargetTracker::reset()
+{
+    tracks_.clear();
+    hasTime_ = false;
+}
+
+void TargetTracker::emit(const Track& t, float predictSec)
+{
+    out_.points.emplace_back(t.x.p + t.x.v * predictSec, t.y.p + t.y.v * predictSec);
+    out_.velocities.emplace_back(t.x.v, t.y.v);
+    out_.areas.push_back(t.area);
+    out_.ids.push_back(t.id);
+}
+
+const TrackedPoints& TargetTracker::update(
+    const std::vector<cv::Point2f>& detections,
+    const std::vector<int>&         areas,
+    double                          timeSec,
+    const TrackerParams&            params,
+    const std::vector<cv::Point2f>* held)
+{
+    out_.points.clear();
+    out_.velocities.clear();
+    out_.areas.clear();
+    out_.ids.clear();
+
+    double dt = hasTime_ ? timeSec - lastTime_ : 0.0;
+    if (hasTime_ && (dt <= 0.0 || dt > MAX_FRAME_GAP_SEC))
+    {
+        tracks_.clear();
+        dt = 0.0;
+    }
+    lastTime_ = timeSec;
+    hasTime_  = true;
+
+    const float measVar  = params.measNoisePx * params.measNoisePx;
+    const float accelVar = params.accelNoise * params.accelNoise;
+    const float gate2    = params.gatePx * params.gatePx;
+    const int   nDet     = static_cast<int>(detections.size());
+
+    // 1. 예측
+    for (Track& t : tracks_)
+    {
+        t.x.predict(static_cast<float>(dt), accelVar);
+        t.y.predict(static_cast<float>(dt), accelVar);
+    }
+
+    // 2. 게이트 안의 (트랙, 검출) 쌍을 거리 순으로 탐욕 대응
+    candidates_.clear();
+    for (int ti = 0; ti < static_cast<int>(tracks_.size()); ti++)
+    {
+        const Track& t = tracks_[ti];
+        for (int di = 0; di < nDet; di++)
+        {
+            float dx = detections[di].x - t.x.p;
+            float dy = detections[di].y - t.y.p;
+            float d2 = dx * dx + dy * dy;
+            if (d2 <= gate2) candidates_.push_back({ d2, ti, di });
+        }
+    }
+    std::sort(candidates_.begin(), candidates_.end(),
+              [](const Candidate& a, const Candidate& b) { return a.d2 < b.d2; });
+
+    detTrack_.assign(nDet, -1);
+    trackMatched_.assign(tracks_.size(), 0);
+    for (const Candidate& c : candidates_)
+    {
+        if (trackMatched_[c.track] || detTrack_[c.det] >= 0) continue;
+        trackMatched_[c.track] = 1;
+        detTrack_[c.det]       = c.track;
+    }
+
+    // 3. 보정 / 미검출 카운트
+    for (int di = 0; di < nDet; di++)
+    {
+        int ti = detTrack_[di];
+        if (ti < 0) continue;
+        Track& t = tracks_[ti];
+        t.x.correct(detections[di].x, measVar);
+        t.y.correct(detections[di].y, measVar);
+        t.missed = 0;
+        t.area   = di < static_cast<int>(areas.size()) ? areas[di] : 0;
+    }
+    // 다른 카메라 시야에만 있는 트랙: 가장 가까운 held 점이 게이트 안이면 미검출로 세지 않음
+    if (held) heldUsed_.assign(held->size(), 0);
+    for (size_t ti = 0; ti < tracks_.size(); ti++)
+    {
+        if (trackMatched_[ti]) continue;
+        Track& t = tracks_[ti];
+        int   hold = -1;
+        float best = gate2;
+        for (size_t hi = 0; held && hi < held->size(); hi++)
+        {
+            if (heldUsed_[hi]) continue;
+            float dx = (*held)[hi].x - t.x.p;
+            float dy = (*held)[hi].y - t.y.p;
+            float d2 = dx * dx + dy * dy;
+            if (d2 <= best)
+            {
+                best = d2;
+                hold = static_cast<int>(hi);
+            }
+        }
+        if (hold >= 0)
+        {
+            heldUsed_[hold] = 1;
+            t.missed        = 0;
+        }
+        else
+            ++t.missed;
+    }
+
+    // 오래 못 찾은 트랙 삭제 (생성 순서 = ID 순서 유지)
+    tracks_.erase(std::remove_if(tracks_.begin(), tracks_.end(),
+                                 [&](const Track& t) { return t.missed > params.maxMissed; }),
+                  tracks_.end());
+
+    // 대응되지 않은 검출 → 새 트랙 (뒤에 추가되므로 ID 오름차순 유지)
+    for (int di = 0; di < nDet; di++)
+    {
+        if (detTrack_[di] >= 0) continue;
+        Track t;
+        t.id     = nextId_++;
+        if (nextId_ == 0) nextId_ = 1;     // 0 은 "ID 없음" 으로 예약
+        t.x.init(detections[di].x, measVar);
+        t.y.init(detections[di].y, measVar);
+        t.missed = 0;
+        t.area   = di < static_cast<int>(areas.size()) ? areas[di] : 0;
+        tracks_.push_back(t);
+    }
+
+    // 이번 프레임에 검출됐거나 held 로 유지된 트랙만 출력
+    const float predictSec = params.predictMs * 0.001f;
+    for (const Track& t : tracks_)
+    {
+        if (t.missed == 0) emit(t, predictSec);
+    }
+    return out_;
+}
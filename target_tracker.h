@@ -0,0 +1,90 @@
+#pragma once
+
+#include <opencv2/core/types.hpp>
+#include <cstdint>
+#include <vector>
+
+// ========== 추적 파라미터 (setting.cfg: track_*) ==========
+struct TrackerParams
+{
+    float gatePx      = 40.f;       // 예측 위치와 검출 사이 최대 거리 (타깃 좌표 px)
+    int   maxMissed   = 5;          // 연속으로 이만큼 못 찾으면 트랙 삭제
+    float accelNoise  = 3000.f;     // 가속도 잡음 표준편차 (px/s²) — 클수록 빠른 방향 전환을 따라감
+    float measNoisePx = 0.5f;       // 검출 좌표 잡음 표준편차 (px) — 클수록 더 강하게 평활화
+    float predictMs   = 0.f;        // 출력 위치를 속도 × 이 시간만큼 앞당김 (지연 보상)
+};
+
+// ========== 추적 결과 (트랙 생성 순서 = ID 오름차순, 이번 프레임에 검출됐거나 held 로 유지된 트랙만) ==========
+struct TrackedPoints
+{
+    std::vector<cv::Point2f> points;        // 필터링 + predictMs 만큼 외삽한 위치 (타깃 좌표계)
+    std::vector<cv::Point2f> velocities;    // px/s
+    std::vector<int>         areas;         // 대응된 검출의 블롭 면적
+    std::vector<uint32_t>    ids;           // 트랙 ID (1부터 증가, 트랙이 살아 있는 동안 유지)
+};
+
+// ========== 다중 타깃 추적기 ==========
+// transformCenters() 이후의 타깃 평면 좌표를 프레임 사이에서 트랙에 대응시켜 고정 ID 를 부여한다.
+//   1. 모든 트랙을 상수 속도 칼만 필터로 현재 프레임 시각까지 예측
+//   2. 예측 위치와 검출 사이 거리 ≤ gatePx 인 쌍을 거리 순으로 탐욕 대응 (총 점 수 ≤ 64 라 충분)
+//   3. 대응된 트랙은 보정, 남은 검출은 새 트랙, 못 찾은 트랙은 maxMissed 프레임 후 삭제
+// 칼만 필터는 x / y 축별 독립 2상태 [위치, 속도] — 행렬 할당 없이 스칼라 연산만 사용.
+// 처리 스레드 전용. 내부 벡터는 재사용된다.
+class TargetTracker
+{
+public:
+    TargetTracker();
+
+    // timeSec: 프레임 시각 (초, 단조 증가). 시각이 역행하거나 0.5초 넘게 비면 트랙을 모두 초기화.
+    // held: 이번 측정이 아닌, 다른 카메라가 최근에 본 점 (다중 카메라). 검출과 대응되지 않은 트랙이
+    //       게이트 안에 held 점이 있으면 보정 없이 예측 위치로 유지·출력한다 (점 하나당 트랙 하나).
+    // 반환 참조는 다음 update()/reset() 전까지 유효.
+    const TrackedPoints& update(const std::vector<cv::Point2f>& detections,
+                                const std::vector<int>&         areas,
+                                double                          timeSec,
+                                const TrackerParams&            params,
+                                const std::vector<cv::Point2f>* held = nullptr);
+
+    // 호모그래피가 바뀌거나 해제되면 호출 (ID 는 계속 증가)
+    void reset();
+
+    int trackCount() const { return static_cast<int>(tracks_.size()); }
+
+private:
+    struct Axis
+    {
+        float p = 0.f, v = 0.f;                 // 위치, 속도
+        float P00 = 0.f, P01 = 0.f, P11 = 0.f;  // 공분산 (대칭)
+
+        void init(float z, float measVar);
+        void predict(float dt, float accelVar);
+        void correct(float z, float measVar);
+    };
+
+    struct Track
+    {
+        uint32_t id;
+        Axis     x, y;
+        int      missed;
+        int      area;
+    };
+
+    struct Candidate
+    {
+        float d2;
+        int   track;
+        int   det;
+    };
+
+    void emit(const Track& t, float predictSec);
+
+    std::vector<Track>     tracks_;
+    std::vector<Candidate> candidates_;
+    std::vector<int>       detTrack_;       // 검출 → 대응된 트랙 인덱스 (-1 = 없음)
+    std::vector<char>      trackMatched_;
+    std::vector<char>      heldUsed_;
+    TrackedPoints          out_;
+    uint32_t               nextId_   = 1;
+    double                 lastTime_ = 0.0;
+    bool                   hasTime_  = false;
+};
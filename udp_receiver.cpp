@@ -3,7 +3,9 @@
  *
  * IRViewer로부터 UDP로 전송된 좌표를 수신하여 캔버스에 실시간 시각화.
  *
- * 패킷 포맷: "x1,y1;x2,y2;..." (세미콜론으로 복수 좌표 구분)
+ * 패킷 포맷 (자동 판별):
+ *   - 텍스트: "x1,y1;x2,y2;..." (세미콜론으로 복수 좌표 구분, 좌표는 정수 또는 소수)
+ *   - 바이너리: IRTP (packet_format.h) — 시퀀스 번호로 손실/순서 뒤바뀜, 캡처 시각으로 지연 표시
  *
  * - 수신 포트: 7777 (기본값)
  * - 시작 시 해상도 설정 창 표시 (기본값: 1024x768)
@@ -15,6 +17,8 @@
 #include <ws2tcpip.h>
 #include <Windows.h>
 
+#include "packet_format.h"
+
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include <string>
@@ -24,6 +28,7 @@
 #include <chrono>
 #include <utility>
 #include <algorithm>
+#include <cmath>
 
 // ===== 고정 설정 =====
 constexpr int UDP_PORT     = 7777;
@@ -32,6 +37,55 @@ constexpr int TRAIL_FRAMES = 40;
 
 using PointList = std::vector<std::pair<int, int>>;
 
+// ===== IRTP 바이너리 패킷 수신 통계 =====
+struct BinaryStats
+{
+    bool     active     = false;    // 바이너리 패킷을 한 번이라도 받았는지
+    bool     haveSeq    = false;
+    uint32_t lastSeq    = 0;
+    uint32_t lastFrame  = 0;
+    long     lost       = 0;        // 시퀀스 공백으로 추정한 손실 수
+    long     reordered  = 0;        // 이전보다 작은(늦게 도착한) 시퀀스 수
+    double   latencyMs  = 0.0;      // 캡처 → 수신 지연 (지수 평활, 송수신 호스트 시계 동기 가정)
+};
+
+static void updateBinaryStats(BinaryStats& st, const PacketHeader& h)
+{
+    st.active    = true;
+    st.lastFrame = h.frameId;
+
+    if (st.haveSeq)
+    {
+        int32_t diff = static_cast<int32_t>(h.sequence - st.lastSeq);
+        if (diff > 0)
+        {
+            st.lost   += diff - 1;
+            st.lastSeq = h.sequence;
+        }
+        else if (diff < -1000)
+        {
+            st.lastSeq = h.sequence;    // 송신측 재시작
+        }
+        else
+        {
+            // 늦게 도착한 패킷: 앞서 손실로 셌던 것이므로 되돌림
+            st.reordered++;
+            if (st.lost > 0) st.lost--;
+        }
+    }
+    else
+    {
+        st.lastSeq = h.sequence;
+        st.haveSeq = true;
+    }
+
+    if (h.captureTimeUs != 0)
+    {
+        double ms = static_cast<double>(static_cast<int64_t>(wallClockMicros() - h.captureTimeUs)) / 1000.0;
+        st.latencyMs = (st.latencyMs == 0.0) ? ms : st.latencyMs * 0.9 + ms * 0.1;
+    }
+}
+
 // ========== 해상도 설정 다이얼로그 ==========
 #define IDC_RES_WIDTH  301
 #define IDC_RES_HEIGHT 302
@@ -285,6 +339,9 @@ int main()
 
     // ===== 상태 변수 =====
     std::deque<PointList> history;
+    BinaryStats              binStats;
+    PacketHeader             binHeader;
+    std::vector<PacketPoint> binPoints;
     std::string lastRawMsg   = "";
     int         totalPackets = 0;
     auto        lastRecvTime = std::chrono::steady_clock::now();
@@ -301,7 +358,40 @@ int main()
         int bytes = recvfrom(recvSocket, buf, sizeof(buf) - 1, 0,
                              reinterpret_cast<sockaddr*>(&senderAddr), &senderLen);
 
-        if (bytes > 0)
+        if (bytes > 0 && isBinaryPacket(reinterpret_cast<const uint8_t*>(buf), bytes))
+        {
+            totalPackets++;
+            connected    = true;
+            lastRecvTime = std::chrono::steady_clock::now();
+
+            PointList currentPoints;
+            if (decodeBinaryPacket(reinterpret_cast<const uint8_t*>(buf), bytes, binHeader, binPoints))
+            {
+                updateBinaryStats(binStats, binHeader);
+                for (const PacketPoint& p : binPoints)
+                    currentPoints.emplace_back(static_cast<int>(std::lround(p.x)),
+                                               static_cast<int>(std::lround(p.y)));
+
+                char info[160];
+                snprintf(info, sizeof(info), "IRTP seq=%u frame=%u pts=%u%s%s",
+                         binHeader.sequence, binHeader.frameId, binHeader.count,
+                         (binHeader.flags & PACKET_FLAG_AREA) ? " +area" : "",
+                         (binHeader.flags & PACKET_FLAG_ID)   ? " +id"   : "");
+                lastRawMsg = info;
+            }
+            else
+            {
+                lastRawMsg = "(invalid IRTP packet, " + std::to_string(bytes) + " bytes)";
+            }
+
+            if (!currentPoints.empty())
+            {
+                history.push_front(currentPoints);
+                if ((int)history.size() > TRAIL_FRAMES)
+                    history.pop_back();
+            }
+        }
+        else if (bytes > 0)
         {
             buf[bytes] = '\0';
             lastRawMsg = std::string(buf);
@@ -309,7 +399,8 @@ int main()
             connected    = true;
             lastRecvTime = std::chrono::steady_clock::now();
 
-            // 파싱: "x1,y1;x2,y2;..."
+            // 파싱: "x1,y1;x2,y2;..." (udp_decimals > 0 이면 소수 좌표 → 반올림해 표시)
+            // tracking=1 이면 "x,y,id" — stof 가 두 번째 ',' 에서 멈추므로 ID 는 무시됨
             PointList currentPoints;
             std::istringstream ss(lastRawMsg);
             std::string token;
@@ -319,8 +410,8 @@ int main()
                 if (comma == std::string::npos) continue;
                 try
                 {
-                    int x = std::stoi(token.substr(0, comma));
-                    int y = std::stoi(token.substr(comma + 1));
+                    int x = static_cast<int>(std::lround(std::stof(token.substr(0, comma))));
+                    int y = static_cast<int>(std::lround(std::stof(token.substr(comma + 1))));
                     currentPoints.emplace_back(x, y);
                 }
                 catch (...) {}
@@ -367,6 +458,16 @@ int main()
         cv::putText(canvas, "Packets: " + std::to_string(totalPackets),
                     {430, py + 18}, cv::FONT_HERSHEY_SIMPLEX, 0.55, cv::Scalar(160, 160, 160), 1);
 
+        if (binStats.active)
+        {
+            char statStr[128];
+            snprintf(statStr, sizeof(statStr), "Lost: %ld  Reorder: %ld  Latency: %.1f ms",
+                     binStats.lost, binStats.reordered, binStats.latencyMs);
+            cv::putText(canvas, statStr,
+                        {600, py + 18}, cv::FONT_HERSHEY_SIMPLEX, 0.55,
+                        binStats.lost > 0 ? cv::Scalar(60, 120, 255) : cv::Scalar(160, 160, 160), 1);
+        }
+
         std::string lastDisp = lastRawMsg.empty() ? "(none)" : lastRawMsg;
         if (lastDisp.size() > 60) lastDisp = lastDisp.substr(0, 60) + "...";
         cv::putText(canvas, "Last packet: \"" + lastDisp + "\"",
@@ -1,35 +1,121 @@
 #include "udp_sender.h"
-#include <ws2tcpip.h>
 #include <iostream>
 #include <string>
 #include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#if defined(__linux__)
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 UDPSender::~UDPSender()
 {
     stopThread();
-    if (socket_ != INVALID_SOCKET)
-        closesocket(socket_);
+    if (socket_ != INVALID_NET_SOCKET)
+        netClose(socket_);
 }
 
 bool UDPSender::init(const std::string& ip, int port)
 {
     socket_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (socket_ == INVALID_SOCKET)
+    if (socket_ == INVALID_NET_SOCKET)
     {
-        std::cerr << "UDP socket creation failed. Error: " << WSAGetLastError() << std::endl;
+        std::cerr << "UDP socket creation failed. Error: " << netLastError() << std::endl;
         return false;
     }
     updateTarget(ip, port);
     return true;
 }
 
+// "ip:port" → sockaddr_in
+static bool parseTarget(const std::string& text, sockaddr_in& out)
+{
+    size_t colon = text.rfind(':');
+    if (colon == std::string::npos) return false;
+
+    std::string ip = text.substr(0, colon);
+    int port = atoi(text.c_str() + colon + 1);
+    if (port <= 0 || port > 65535) return false;
+
+    memset(&out, 0, sizeof(out));
+    out.sin_family = AF_INET;
+    out.sin_port   = htons(static_cast<uint16_t>(port));
+    return inet_pton(AF_INET, ip.c_str(), &out.sin_addr) == 1;
+}
+
+static bool isMulticast(const sockaddr_in& a)
+{
+    uint32_t host = ntohl(a.sin_addr.s_addr);
+    return (host >> 28) == 0xE;     // 224.0.0.0/4
+}
+
 void UDPSender::updateTarget(const std::string& ip, int port)
 {
-    memset(&addr_, 0, sizeof(addr_));
-    addr_.sin_family = AF_INET;
-    addr_.sin_port   = htons(static_cast<u_short>(port));
-    inet_pton(AF_INET, ip.c_str(), &addr_.sin_addr);
+    memset(&primary_, 0, sizeof(primary_));
+    primary_.sin_family = AF_INET;
+    primary_.sin_port   = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, ip.c_str(), &primary_.sin_addr);
     std::cout << "UDP target: " << ip << ":" << port << std::endl;
+    publishTargets();
+}
+
+void UDPSender::setExtraTargets(const std::string& list)
+{
+    extras_.clear();
+    size_t pos = 0;
+    while (pos <= list.size())
+    {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) comma = list.size();
+
+        std::string item = list.substr(pos, comma - pos);
+        item.erase(0, item.find_first_not_of(" \t"));
+        item.erase(item.find_last_not_of(" \t") + 1);
+        pos = comma + 1;
+        if (item.empty()) continue;
+
+        sockaddr_in addr;
+        if (!parseTarget(item, addr))
+        {
+            std::cerr << "[UDP] Invalid target ignored: " << item << std::endl;
+            continue;
+        }
+        if (static_cast<int>(extras_.size()) + 1 >= TargetList::MAX_TARGETS)
+        {
+            std::cerr << "[UDP] Too many targets, ignored: " << item << std::endl;
+            continue;
+        }
+        extras_.push_back(addr);
+        std::cout << "UDP target: " << item << (isMulticast(addr) ? " (multicast)" : "") << std::endl;
+    }
+    publishTargets();
+}
+
+void UDPSender::setMulticastTtl(int ttl)
+{
+    if (socket_ == INVALID_NET_SOCKET) return;
+    int value = std::max(0, std::min(255, ttl));
+    if (setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_TTL,
+                   reinterpret_cast<const char*>(&value), sizeof(value)) != 0)
+        std::cerr << "[UDP] IP_MULTICAST_TTL failed. Error: " << netLastError() << std::endl;
+}
+
+// 기본 대상 + 추가 대상을 하나의 목록으로 만들어 전송 스레드에 게시
+void UDPSender::publishTargets()
+{
+    TargetList& list = targets_.writeBuffer();
+    list.count = 0;
+    list.addrs[list.count++] = primary_;
+    for (const sockaddr_in& a : extras_)
+    {
+        if (list.count >= TargetList::MAX_TARGETS) break;
+        list.addrs[list.count++] = a;
+    }
+    targets_.publish();
 }
 
 void UDPSender::startThread(int fps)
@@ -45,6 +131,10 @@ void UDPSender::stopThread()
 {
     if (!threadRunning_.load()) return;
     threadRunning_.store(false);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+    }
+    wakeCv_.notify_one();
     if (sendThread_.joinable())
         sendThread_.join();
     std::cout << "[UDP] Send thread stopped." << std::endl;
@@ -56,36 +146,176 @@ void UDPSender::setFps(int fps)
     std::cout << "[UDP] FPS updated to " << fps << std::endl;
 }
 
-void UDPSender::updatePoints(const std::vector<cv::Point2f>& points)
+void UDPSender::setSendMode(UdpSendMode mode, int minIntervalUs, int keepaliveMs)
+{
+    sendMode_.store(static_cast<int>(mode));
+    minIntervalUs_.store(std::max(0, minIntervalUs));
+    keepaliveMs_.store(std::max(0, keepaliveMs));
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+    }
+    wakeCv_.notify_one();
+    std::cout << "[UDP] Send mode: " << udpSendModeName(mode)
+              << " (min interval " << minIntervalUs << " us, keepalive " << keepaliveMs << " ms)" << std::endl;
+}
+
+void UDPSender::setExtrapolation(int horizonMs, int targetWidth, int targetHeight)
+{
+    extrapolateMs_.store(std::max(0, horizonMs));
+    targetWidth_.store(targetWidth);
+    targetHeight_.store(targetHeight);
+    if (horizonMs > 0)
+        std::cout << "[UDP] Send-time extrapolation: horizon " << horizonMs << " ms, clamp "
+                  << targetWidth << "x" << targetHeight << std::endl;
+}
+
+// MAX_POINTS 로 자른 좌표 수 (처음 한 번만 경고)
+int UDPSender::beginBatch(size_t pointCount)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    points_ = points;
+    int n = static_cast<int>(pointCount);
+    if (n > PointBatch::MAX_POINTS)
+    {
+        if (!truncationWarned_)
+        {
+            std::cerr << "[UDP] " << n << " points exceed batch capacity ("
+                      << PointBatch::MAX_POINTS << "), extra points dropped." << std::endl;
+            truncationWarned_ = true;
+        }
+        n = PointBatch::MAX_POINTS;
+    }
+    return n;
+}
+
+void UDPSender::publishBatch(uint32_t frameId, uint64_t captureTimeUs, const FrameTimestamps* timing)
+{
+    PointBatch& batch = latest_.writeBuffer();
+    batch.frameId       = frameId;
+    batch.captureTimeUs = captureTimeUs;
+    batch.timing        = timing ? *timing : FrameTimestamps{};
+    batch.updateTimeNs  = steadyNowNs();
+    latest_.publish();
+
+    // 좌표 전달은 lock-free. 깨우기만 mutex 를 거쳐 lost wakeup 방지 (전송 스레드가 대기 중일 때만 경합)
+    updateSeq_.fetch_add(1, std::memory_order_release);
+    if (static_cast<UdpSendMode>(sendMode_.load()) == UdpSendMode::Event)
+    {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+        }
+        wakeCv_.notify_one();
+    }
+}
+
+void UDPSender::updatePoints(const std::vector<cv::Point2f>& points,
+                             const std::vector<int>*         areas,
+                             uint32_t                        frameId,
+                             uint64_t                        captureTimeUs,
+                             const FrameTimestamps*          timing)
+{
+    PointBatch& batch = latest_.writeBuffer();
+    int n = beginBatch(points.size());
+    std::copy(points.begin(), points.begin() + n, batch.points);
+    batch.count         = n;
+    batch.hasAreas      = areas != nullptr && static_cast<int>(areas->size()) >= n;
+    batch.hasIds        = false;
+    batch.hasVelocities = false;
+    if (batch.hasAreas)
+    {
+        for (int i = 0; i < n; i++) batch.areas[i] = static_cast<uint32_t>((*areas)[i]);
+    }
+    publishBatch(frameId, captureTimeUs, timing);
+}
+
+void UDPSender::updatePoints(const TrackedPoints&   tracked,
+                             uint32_t               frameId,
+                             uint64_t               captureTimeUs,
+                             const FrameTimestamps* timing)
+{
+    PointBatch& batch = latest_.writeBuffer();
+    int n = beginBatch(tracked.points.size());
+    std::copy(tracked.points.begin(),     tracked.points.begin() + n,     batch.points);
+    std::copy(tracked.ids.begin(),        tracked.ids.begin() + n,        batch.ids);
+    std::copy(tracked.velocities.begin(), tracked.velocities.begin() + n, batch.velocities);
+    for (int i = 0; i < n; i++) batch.areas[i] = static_cast<uint32_t>(tracked.areas[i]);
+    batch.count         = n;
+    batch.hasAreas      = true;
+    batch.hasIds        = true;
+    batch.hasVelocities = true;
+    publishBatch(frameId, captureTimeUs, timing);
+}
+
+// Event 모드: 새 좌표, keepalive 시점, 종료 중 먼저 오는 것까지 대기.
+// 새 좌표면 최소 간격을 지킨 뒤 반환 (그 사이 들어온 좌표는 최신 것 하나로 합쳐짐).
+void UDPSender::waitForUpdate(uint64_t& seenSeq, std::chrono::steady_clock::time_point lastSend)
+{
+    using Clock = std::chrono::steady_clock;
+
+    int  keepaliveMs = keepaliveMs_.load();
+    auto deadline    = (keepaliveMs > 0)
+                     ? lastSend + std::chrono::milliseconds(keepaliveMs)
+                     : Clock::now() + std::chrono::milliseconds(100);   // 모드 변경 재확인 주기
+    {
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wakeCv_.wait_until(lock, deadline, [&]
+        {
+            return updateSeq_.load(std::memory_order_acquire) != seenSeq || !threadRunning_.load() ||
+                   static_cast<UdpSendMode>(sendMode_.load()) != UdpSendMode::Event;
+        });
+    }
+
+    if (updateSeq_.load(std::memory_order_acquire) != seenSeq)
+    {
+        auto earliest = lastSend + std::chrono::microseconds(minIntervalUs_.load());
+        if (Clock::now() < earliest)
+            std::this_thread::sleep_until(earliest);
+        seenSeq = updateSeq_.load(std::memory_order_acquire);
+    }
 }
 
 void UDPSender::sendLoop()
 {
-    int sendCount = 0;
-    auto secStart = std::chrono::steady_clock::now();
+    using Clock = std::chrono::steady_clock;
+
+    int      sendCount = 0;
+    auto     secStart  = Clock::now();
+    auto     lastSend  = Clock::now();
+    uint64_t seenSeq   = updateSeq_.load();
 
     while (threadRunning_.load())
     {
-        auto start = std::chrono::steady_clock::now();
+        auto start     = Clock::now();
+        bool eventMode = static_cast<UdpSendMode>(sendMode_.load()) == UdpSendMode::Event;
 
-        // 최신 좌표 복사
-        std::vector<cv::Point2f> pts;
+        bool keepalive = false;
+        if (eventMode)
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            pts = points_;
+            uint64_t before = seenSeq;
+            waitForUpdate(seenSeq, lastSend);
+            if (!threadRunning_.load()) break;
+            if (seenSeq == before)
+            {
+                // 새 좌표 없이 깨어남: keepalive 시점이면 재전송, 아니면 (모드 변경 등) 다시 확인
+                keepalive = keepaliveMs_.load() > 0 &&
+                            Clock::now() >= lastSend + std::chrono::milliseconds(keepaliveMs_.load());
+                if (!keepalive) continue;
+            }
         }
 
-        if (!pts.empty())
+        // 최신 좌표 (새 값이 없으면 직전 값을 그대로 재전송)
+        bool fresh = latest_.update();
+        const PointBatch& batch = latest_.read();
+
+        if (batch.count > 0)
         {
-            sendPacket(pts);
+            sendPacket(extrapolate(batch));
             ++sendCount;
+            if (fresh && trace_)
+                trace_->record(batch.timing, batch.updateTimeNs, steadyNowNs());
         }
+        lastSend = Clock::now();
 
         // 1초마다 실제 FPS 갱신
-        auto now = std::chrono::steady_clock::now();
+        auto now = Clock::now();
         auto secElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - secStart).count();
         if (secElapsed >= 1000)
         {
@@ -94,29 +324,119 @@ void UDPSender::sendLoop()
             secStart = now;
         }
 
-        // 목표 간격만큼 대기
-        int targetUs = 1000000 / fps_.load();
-        auto elapsed = now - start;
-        auto sleepTime = std::chrono::microseconds(targetUs) -
-                         std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
-        if (sleepTime.count() > 0)
-            std::this_thread::sleep_for(sleepTime);
+        // Fixed 모드: 목표 간격만큼 대기
+        if (!eventMode)
+        {
+            int targetUs = 1000000 / fps_.load();
+            auto elapsed = now - start;
+            auto sleepTime = std::chrono::microseconds(targetUs) -
+                             std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+            if (sleepTime.count() > 0)
+                std::this_thread::sleep_for(sleepTime);
+        }
     }
     actualFps_.store(0);
 }
 
-void UDPSender::sendPacket(const std::vector<cv::Point2f>& points)
+// 추적 속도로 좌표를 지금 시각까지 외삽 (최대 horizon, 타깃 영역으로 제한).
+// udp_fps > 카메라 fps 일 때 같은 좌표를 반복 전송하며 생기는 계단 현상을 없앤다.
+// 외삽이 꺼져 있거나 속도/프레임 시각이 없으면 batch 를 그대로 반환.
+const PointBatch& UDPSender::extrapolate(const PointBatch& batch)
 {
-    if (socket_ == INVALID_SOCKET || points.empty()) return;
+    int horizonMs = extrapolateMs_.load();
+    if (horizonMs <= 0 || !batch.hasVelocities || batch.timing.acquireNs == 0) return batch;
+
+    int64_t elapsedNs = std::max<int64_t>(0, steadyNowNs() - batch.timing.acquireNs);
+    float   dt        = static_cast<float>(std::min<int64_t>(elapsedNs, horizonMs * 1000000LL)) * 1e-9f;
+    float   maxX      = static_cast<float>(targetWidth_.load()  - 1);
+    float   maxY      = static_cast<float>(targetHeight_.load() - 1);
 
-    std::string msg;
-    for (size_t i = 0; i < points.size(); i++)
+    extrapolated_ = batch;
+    for (int i = 0; i < batch.count; i++)
     {
-        if (i > 0) msg += ";";
-        msg += std::to_string(static_cast<int>(points[i].x))
-             + ","
-             + std::to_string(static_cast<int>(points[i].y));
+        cv::Point2f& p = extrapolated_.points[i];
+        p.x = std::max(0.f, std::min(maxX, p.x + batch.velocities[i].x * dt));
+        p.y = std::max(0.f, std::min(maxY, p.y + batch.velocities[i].y * dt));
     }
-    sendto(socket_, msg.c_str(), static_cast<int>(msg.length()),
-           0, reinterpret_cast<const sockaddr*>(&addr_), sizeof(addr_));
+    return extrapolated_;
+}
+
+void UDPSender::sendPacket(const PointBatch& batch)
+{
+    if (socket_ == INVALID_NET_SOCKET || batch.count == 0) return;
+
+    if (static_cast<PacketFormat>(format_.load()) == PacketFormat::Binary)
+    {
+        int len = formatBinaryPacket(batch);
+        if (len > 0) sendToAll(reinterpret_cast<const char*>(binaryPacket_), len);
+    }
+    else
+    {
+        int len = formatTextPacket(batch);
+        sendToAll(packet_.c_str(), len);
+    }
+}
+
+// 같은 패킷을 모든 대상에 전송. Linux 는 sendmmsg, Windows 는 대상별 sendto
+// (Winsock 에는 다중 목적지 배치 전송이 없음 — 패킷은 한 번만 만들고 주소만 바꿔 보냄).
+// sendmmsg 는 처음 실패한 메시지에서 멈추므로 (경로 없는 유니캐스트 / 멀티캐스트 등) 그 대상만 건너뛰고
+// 나머지로 다시 호출한다 — Windows 경로처럼 대상 하나의 오류가 다른 대상 전송을 막지 않게.
+void UDPSender::sendToAll(const char* data, int length)
+{
+    targets_.update();
+    const TargetList& list = targets_.read();
+
+#if defined(__linux__)
+    struct iovec   iov = { const_cast<char*>(data), static_cast<size_t>(length) };
+    struct mmsghdr msgs[TargetList::MAX_TARGETS];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < list.count; i++)
+    {
+        msgs[i].msg_hdr.msg_name    = const_cast<sockaddr_in*>(&list.addrs[i]);
+        msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        msgs[i].msg_hdr.msg_iov     = &iov;
+        msgs[i].msg_hdr.msg_iovlen  = 1;
+    }
+    unsigned int next  = 0;
+    unsigned int total = static_cast<unsigned int>(list.count);
+    while (next < total)
+    {
+        int n = sendmmsg(socket_, msgs + next, total - next, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n > 0) next += static_cast<unsigned int>(n);
+        // 남은 게 있으면 메시지 next 가 실패한 것 (n < 0 이면 첫 메시지) → 그 대상만 건너뜀
+        if (next < total) next++;
+    }
+#else
+    for (int i = 0; i < list.count; i++)
+        sendto(socket_, data, length, 0,
+               reinterpret_cast<const sockaddr*>(&list.addrs[i]), sizeof(sockaddr_in));
+#endif
+}
+
+// 기존 텍스트 포맷 "x1,y1;x2,y2;..." (추적 ID 가 있으면 "x1,y1,id1;...") → packet_
+int UDPSender::formatTextPacket(const PointBatch& batch)
+{
+    // cv::Point2f 는 {float x, float y} 연속 배치
+    return ::formatTextPacket(packet_, &batch.points[0].x, batch.count, decimals_.load(),
+                              batch.hasIds ? batch.ids : nullptr);
+}
+
+// IRTP 바이너리 포맷 → binaryPacket_ (sequence 는 전송할 때마다 증가)
+int UDPSender::formatBinaryPacket(const PointBatch& batch)
+{
+    PacketHeader header;
+    header.count         = static_cast<uint16_t>(batch.count);
+    header.sequence      = sequence_++;
+    header.frameId       = batch.frameId;
+    header.captureTimeUs = batch.captureTimeUs;
+    bool withArea = sendArea_.load() && batch.hasAreas;
+    if (withArea)     header.flags |= PACKET_FLAG_AREA;
+    if (batch.hasIds) header.flags |= PACKET_FLAG_ID;
+
+    // cv::Point2f 는 {float x, float y} 연속 배치
+    return static_cast<int>(encodeBinaryPacket(
+        binaryPacket_, sizeof(binaryPacket_), header,
+        &batch.points[0].x, withArea ? batch.areas : nullptr,
+        batch.hasIds ? batch.ids : nullptr));
 }
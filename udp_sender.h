@@ -1,16 +1,47 @@
 #pragma once
 
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-#include <winsock2.h>
+#include "net_compat.h"
+#include "latest_value.h"
+#include "latency_trace.h"
+#include "packet_format.h"
+#include "target_tracker.h"
 
 #include <opencv2/core/types.hpp>
 #include <vector>
 #include <string>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
+#include <chrono>
+
+// ========== 전송 스레드로 넘기는 고정 크기 좌표 묶음 ==========
+struct PointBatch
+{
+    static constexpr int MAX_POINTS = 64;
+
+    int         count         = 0;
+    bool        hasAreas      = false;
+    bool        hasIds        = false;      // 추적 ID 포함 (tracking=1)
+    bool        hasVelocities = false;      // 추적 속도 포함 → 전송 시각까지 외삽 가능
+    uint32_t    frameId       = 0;
+    uint64_t    captureTimeUs = 0;      // system_clock µs (바이너리 패킷 헤더로 전달)
+    int64_t     updateTimeNs  = 0;      // updatePoints() 호출 시각 (steady_clock, 지연 측정용)
+    FrameTimestamps timing;             // 이 좌표를 만든 프레임의 acquire / detect 시각
+    cv::Point2f points[MAX_POINTS];
+    uint32_t    areas[MAX_POINTS];
+    uint32_t    ids[MAX_POINTS];
+    cv::Point2f velocities[MAX_POINTS];     // px/s (타깃 좌표계)
+};
+
+// ========== 전송 대상 목록 (고정 크기, 전송 스레드로 통째로 교체 전달) ==========
+struct TargetList
+{
+    static constexpr int MAX_TARGETS = 8;
+
+    int         count = 0;
+    sockaddr_in addrs[MAX_TARGETS];
+};
 
 // ========== UDP 전송 클래스 (별도 스레드) ==========
 class UDPSender
@@ -19,12 +50,19 @@ public:
     UDPSender() = default;
     ~UDPSender();
 
-    // WSAStartup은 호출자(main)가 담당. 소켓만 생성/관리.
+    // netStartup()(WSAStartup)은 호출자(main)가 담당. 소켓만 생성/관리.
     bool init(const std::string& ip, int port);
 
-    // P키로 설정 변경 시 대상 주소 갱신
+    // P키로 설정 변경 시 기본 대상 주소 갱신 (대상 목록의 첫 항목)
     void updateTarget(const std::string& ip, int port);
 
+    // 추가 대상 "ip:port,ip:port,..." (setting.cfg: udp_targets). 멀티캐스트 그룹 주소 허용.
+    // 기본 대상과 합쳐 최대 MAX_TARGETS 개. 잘못된 항목은 로그 후 무시.
+    void setExtraTargets(const std::string& list);
+
+    // 멀티캐스트 TTL (1 = 같은 서브넷)
+    void setMulticastTtl(int ttl);
+
     // 전송 스레드 시작/중지
     void startThread(int fps);
     void stopThread();
@@ -32,24 +70,91 @@ public:
     // 전송 FPS 런타임 변경
     void setFps(int fps);
 
-    // 메인 루프에서 호출: 최신 좌표를 스레드에 전달
-    void updatePoints(const std::vector<cv::Point2f>& points);
+    // 텍스트 패킷 좌표 소수 자릿수 (0 = 기존 정수 포맷 "x,y")
+    void setDecimals(int decimals) { decimals_.store(decimals); }
+
+    // 패킷 포맷 (텍스트 / IRTP 바이너리). withArea 는 바이너리에서만 의미 있음.
+    void setFormat(PacketFormat format, bool withArea)
+    {
+        format_.store(static_cast<int>(format));
+        sendArea_.store(withArea);
+    }
+
+    // 전송 방식. Event 모드: 새 좌표마다 즉시 전송하되 minIntervalUs 보다 촘촘하게는 보내지 않고,
+    // keepaliveMs 동안 새 좌표가 없으면 마지막 좌표를 재전송 (0 = 재전송 안 함).
+    void setSendMode(UdpSendMode mode, int minIntervalUs, int keepaliveMs);
+
+    // 전송 시점 외삽 (setting.cfg: udp_extrapolate_ms). 추적 속도가 있는 좌표를 매 전송마다
+    // "acquire 이후 경과 시간" 만큼 앞당겨 보내되 horizonMs 를 넘겨 외삽하지 않고,
+    // 결과는 타깃 영역 [0, targetW-1] × [0, targetH-1] 로 제한. horizonMs 0 = 끔.
+    void setExtrapolation(int horizonMs, int targetWidth, int targetHeight);
+
+    // 처리 스레드(단일 생산자)에서 호출: 최신 좌표를 전송 스레드에 전달.
+    // 할당 없음. MAX_POINTS 를 넘는 좌표는 잘림. Event 모드면 전송 스레드를 깨움.
+    // areas 는 points 와 같은 순서의 블롭 면적 (없으면 nullptr).
+    // timing 은 종단 간 지연 기록용 프레임 단계별 시각 (없으면 전송 구간만 기록).
+    void updatePoints(const std::vector<cv::Point2f>& points,
+                      const std::vector<int>*         areas         = nullptr,
+                      uint32_t                        frameId       = 0,
+                      uint64_t                        captureTimeUs = 0,
+                      const FrameTimestamps*          timing        = nullptr);
+
+    // 추적 결과 전달: 좌표마다 ID (텍스트 "x,y,id", 바이너리 PACKET_FLAG_ID) 와 외삽용 속도 포함
+    void updatePoints(const TrackedPoints&   tracked,
+                      uint32_t               frameId,
+                      uint64_t               captureTimeUs,
+                      const FrameTimestamps* timing);
 
     bool isRunning() const { return threadRunning_.load(); }
     int  actualFps()  const { return actualFps_.load(); }
 
+    // 새 좌표의 첫 전송마다 단계별 지연을 기록할 대상 (keepalive 재전송 제외).
+    // startThread() 전에 설정. trace 는 UDPSender 보다 오래 살아야 함.
+    void setLatencyTrace(LatencyTrace* trace) { trace_ = trace; }
+
 private:
-    SOCKET      socket_ = INVALID_SOCKET;
-    sockaddr_in addr_   = {};
+    NetSocket   socket_ = INVALID_NET_SOCKET;
+
+    // 대상 목록: 설정 스레드(main)가 만들어 publish, 전송 스레드는 락 없이 최신 목록을 읽음
+    sockaddr_in              primary_ = {};
+    std::vector<sockaddr_in> extras_;                   // 설정 스레드 전용
+    LatestValue<TargetList>  targets_;
+    void publishTargets();
 
     // 전송 스레드
     std::thread         sendThread_;
-    std::mutex          mutex_;
     std::atomic<bool>   threadRunning_{false};
     std::atomic<int>    fps_{60};
     std::atomic<int>    actualFps_{0};
-    std::vector<cv::Point2f> points_;   // mutex_ 로 보호
+    std::atomic<int>    decimals_{0};
+    std::atomic<int>    format_{static_cast<int>(PacketFormat::Text)};
+    std::atomic<bool>   sendArea_{false};
+    std::atomic<int>    sendMode_{static_cast<int>(UdpSendMode::Fixed)};
+    std::atomic<int>    minIntervalUs_{0};
+    std::atomic<int>    keepaliveMs_{100};
+    std::atomic<int>    extrapolateMs_{0};
+    std::atomic<int>    targetWidth_{1024};
+    std::atomic<int>    targetHeight_{768};
+
+    // Event 모드 깨우기: updateSeq_ 가 바뀌면 새 좌표 (좌표 자체는 latest_ 로 전달)
+    std::mutex              wakeMutex_;
+    std::condition_variable wakeCv_;
+    std::atomic<uint64_t>   updateSeq_{0};
+    LatencyTrace*           trace_ = nullptr;
+    LatestValue<PointBatch> latest_;    // 처리 스레드 → 전송 스레드
+    bool                    truncationWarned_ = false;  // 생산자 전용
+    std::string             packet_;                    // 전송 스레드 전용 (capacity 재사용)
+    uint32_t                sequence_ = 0;              // 전송 스레드 전용
+    PointBatch              extrapolated_;              // 전송 스레드 전용 (외삽 결과)
+    uint8_t                 binaryPacket_[PACKET_HEADER_SIZE + PACKET_MAX_POINT_SIZE * PointBatch::MAX_POINTS];
 
     void sendLoop();
-    void sendPacket(const std::vector<cv::Point2f>& points);
+    void waitForUpdate(uint64_t& seenSeq, std::chrono::steady_clock::time_point lastSend);
+    int  beginBatch(size_t pointCount);
+    void publishBatch(uint32_t frameId, uint64_t captureTimeUs, const FrameTimestamps* timing);
+    const PointBatch& extrapolate(const PointBatch& batch);
+    void sendPacket(const PointBatch& batch);
+    void sendToAll(const char* data, int length);
+    int  formatTextPacket(const PointBatch& batch);
+    int  formatBinaryPacket(const PointBatch& batch);
 };